@@ -42,6 +42,7 @@ const char GroupBrowser[] = "browser";
 const char GroupDocsets[] = "docsets";
 const char GroupGlobalShortcuts[] = "global_shortcuts";
 const char GroupInternal[] = "internal";
+const char GroupSearch[] = "search";
 const char GroupState[] = "state";
 const char GroupProxy[] = "proxy";
 }
@@ -87,6 +88,11 @@ void Settings::load()
 #endif
     m_settings->endGroup();
 
+    m_settings->beginGroup(GroupSearch);
+    fuzzySearch = m_settings->value(QStringLiteral("fuzzy_search"), false).toBool();
+    prefetchSearch = m_settings->value(QStringLiteral("prefetch"), false).toBool();
+    m_settings->endGroup();
+
     m_settings->beginGroup(GroupBrowser);
     minimumFontSize = m_settings->value(QStringLiteral("minimum_font_size"),
                                         QWebSettings::globalSettings()->fontSize(QWebSettings::MinimumFontSize)).toInt();
@@ -162,6 +168,11 @@ void Settings::save()
     m_settings->setValue(QStringLiteral("show"), showShortcut);
     m_settings->endGroup();
 
+    m_settings->beginGroup(GroupSearch);
+    m_settings->setValue(QStringLiteral("fuzzy_search"), fuzzySearch);
+    m_settings->setValue(QStringLiteral("prefetch"), prefetchSearch);
+    m_settings->endGroup();
+
     m_settings->beginGroup(GroupBrowser);
     m_settings->setValue(QStringLiteral("minimum_font_size"), minimumFontSize);
     m_settings->endGroup();
@@ -53,6 +53,10 @@ public:
     QKeySequence showShortcut;
     /// TODO: QKeySequence searchSelectedTextShortcut;
 
+    // Search
+    bool fuzzySearch;
+    bool prefetchSearch;
+
     // Browser
     int minimumFontSize;
     /// TODO: bool askOnExternalLink;
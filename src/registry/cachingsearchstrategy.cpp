@@ -24,69 +24,48 @@
 #include "cachingsearchstrategy.h"
 #include "docset.h"
 
+#include "prefixcache.h"
 #include "searchresult.h"
 #include "searchquery.h"
+#include "searchstatistics.h"
 
 using namespace Zeal;
 
 CachingSearchStrategy::CachingSearchStrategy(std::unique_ptr<DocsetSearchStrategy> strategy)
-    : m_cache(CachingSearchStrategy::CacheSize),
-      m_search(std::move(strategy))
+    : m_search(std::move(strategy))
 {
 }
 
-QList<SearchResult> CachingSearchStrategy::search(const SearchQuery &searchQuery, CancellationToken token)
+CachingSearchStrategy::~CachingSearchStrategy()
 {
-    QString candidate = getCacheEntry(searchQuery);
-    if (!candidate.isEmpty()) {
-        return searchWithCache(searchQuery, candidate);
-    } else {
-        return searchWithoutCache(searchQuery, token);
-    }
+    PrefixCache::instance()->remove(this);
 }
 
-bool CachingSearchStrategy::validResult(const SearchQuery &searchQuery, SearchResult previousResult,
-        SearchResult &result)
+QList<SearchResult> CachingSearchStrategy::search(const SearchQuery &searchQuery, CancellationToken token)
 {
-    return m_search->validResult(searchQuery, previousResult, result);
-}
+    // Search is case insensitive, so are cache keys
+    const QString key = searchQuery.foldedQuery();
+    const PrefixCache::Ids candidates = PrefixCache::instance()->find(this, key);
 
-QString CachingSearchStrategy::getCacheEntry(const SearchQuery &searchQuery) const
-{
-    for (int i = searchQuery.query().size(); i > 0; i--) {
-        QString candidate = searchQuery.query().mid(0, i);
+    QList<SearchResult> results;
+    QVector<int> matches;
+    if (!m_search->searchSymbols(searchQuery, candidates.get(), token, results, matches))
+        return m_search->search(searchQuery, token);
 
-        /// Use the cache only if the cache entry contains all results.
-        /// Also check that the entry is a true prefix.
-        if (m_cache.contains(candidate)
-                && m_cache[candidate]->size() < Docset::MaxDocsetResultsCount)
-            return candidate;
-    }
-    return QString();
-}
+    SearchStatistics::instance()->recordCacheLookup(candidates != nullptr);
 
-QList<SearchResult> CachingSearchStrategy::searchWithCache(const SearchQuery &searchQuery, const QString &prefix)
-{
-    QList<SearchResult> *prefixResults = m_cache[prefix];
-    QList<SearchResult> results;
-    QListIterator<SearchResult> prefixResultsIterator(*prefixResults);
-    while (prefixResultsIterator.hasNext()) {
-        SearchResult previousResult = prefixResultsIterator.next();
-        SearchResult result;
-        if (validResult(searchQuery, previousResult, result))
-            results.append(result);
-    }
+    // Cache all matching ids rather than ids of the truncated results, so that
+    // narrowing a query with many matches is still answered from memory.
+    // Ids of a cancelled search may be partial.
+    if (!token.isCancelled())
+        PrefixCache::instance()->insert(this, key, matches);
 
-    m_cache.insert(searchQuery.query(), new QList<SearchResult>(results));
     return results;
 }
 
-QList<SearchResult> CachingSearchStrategy::searchWithoutCache(const SearchQuery &searchQuery, CancellationToken token)
+bool CachingSearchStrategy::searchSymbols(const SearchQuery &searchQuery, const QVector<int> *candidates,
+                                          CancellationToken token, QList<SearchResult> &results,
+                                          QVector<int> &matches)
 {
-    QList<SearchResult> results = m_search->search(searchQuery, token);
-
-    /// Only cache the results if they are not partial.
-    if (!token.isCancelled())
-        m_cache.insert(searchQuery.query(), new QList<SearchResult>(results));
-    return results;
+    return m_search->searchSymbols(searchQuery, candidates, token, results, matches);
 }
@@ -27,9 +27,7 @@
 #include "cancellationtoken.h"
 #include "docsetsearchstrategy.h"
 
-#include <QCache>
 #include <QList>
-#include <QString>
 
 #include <memory>
 
@@ -41,9 +39,9 @@ struct SearchResult;
  * @brief The CachingSearchStrategy class
  * A search strategy that decorates another strategy and provides caching.
  *
- * It keeps a cache of the results of previous searches.
- * If the prefix of a search query exists then the results and found
- * by searching the cached results rather than the entire docset.
+ * Ids of all symbols matching previous searches are kept in the shared
+ * PrefixCache, separately from the truncated results. If a prefix of a search
+ * query is cached then only its ids are searched rather than the entire docset.
  *
  * This is because the results for a query prefix are a superset of
  * results for a query.
@@ -52,19 +50,14 @@ class CachingSearchStrategy : public DocsetSearchStrategy
 {
 public:
     CachingSearchStrategy(std::unique_ptr<DocsetSearchStrategy> strategy);
+    ~CachingSearchStrategy() override;
+
     QList<SearchResult> search(const SearchQuery &searchQuery, CancellationToken token) override;
-    bool validResult(const SearchQuery &searchQuery, SearchResult previousResult,
-                     SearchResult &result)override;
+    bool searchSymbols(const SearchQuery &searchQuery, const QVector<int> *candidates,
+                       CancellationToken token, QList<SearchResult> &results,
+                       QVector<int> &matches) override;
 
 private:
-    QString getCacheEntry(const SearchQuery &searchQuery) const;
-    QList<SearchResult> searchWithCache(const SearchQuery &searchQuery, const QString &prefix);
-    QList<SearchResult> searchWithoutCache(const SearchQuery &searchQuery, CancellationToken token);
-
-    // Maximum size of the cache.
-    const static int CacheSize = 10;
-    QCache<QString, QList<SearchResult>> m_cache;
-
     // A decorated search strategy.
     std::unique_ptr<DocsetSearchStrategy> m_search;
 
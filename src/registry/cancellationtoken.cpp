@@ -23,19 +23,52 @@
 
 #include "cancellationtoken.h"
 
+#include <algorithm>
+
 using namespace Zeal;
 
-CancellationToken::CancellationToken()
+CancellationToken::CancellationToken() :
+    m_state(std::make_shared<State>())
 {
-    m_cancelled = std::shared_ptr<bool>(new bool(false));
 }
 
 void CancellationToken::cancel()
 {
-    *m_cancelled = true;
+    QMutexLocker locker(&m_state->mutex);
+    if (m_state->cancelled.exchange(true, std::memory_order_acq_rel))
+        return;
+
+    // Called under the lock, so that unregistered callbacks are never called afterwards
+    for (const auto &callback : m_state->callbacks)
+        callback.second();
+    m_state->callbacks.clear();
 }
 
 bool CancellationToken::isCancelled() const
 {
-    return *m_cancelled;
+    return m_state->cancelled.load(std::memory_order_acquire);
+}
+
+int CancellationToken::registerCallback(const std::function<void()> &callback) const
+{
+    QMutexLocker locker(&m_state->mutex);
+    const int id = m_state->nextCallbackId++;
+    if (m_state->cancelled.load(std::memory_order_acquire)) {
+        locker.unlock();
+        callback();
+        return id;
+    }
+
+    m_state->callbacks.emplace_back(id, callback);
+    return id;
+}
+
+void CancellationToken::unregisterCallback(int id) const
+{
+    QMutexLocker locker(&m_state->mutex);
+    auto &callbacks = m_state->callbacks;
+    callbacks.erase(std::remove_if(callbacks.begin(), callbacks.end(),
+                                   [id](const std::pair<int, std::function<void()>> &callback) {
+        return callback.first == id;
+    }), callbacks.end());
 }
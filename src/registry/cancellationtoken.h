@@ -24,7 +24,11 @@
 #ifndef CANCELLATIONTOKEN_H
 #define CANCELLATIONTOKEN_H
 
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <vector>
+#include <QMutex>
 #include <QObject>
 
 namespace Zeal {
@@ -33,6 +37,10 @@ namespace Zeal {
  * @brief The CancellationToken struct
  * Token that stores whether cancel was called on it.
  * In async code can be used to check if another thread has cancelled a call.
+ *
+ * Copies share the state, which is safe to use from any thread. Work that
+ * cannot poll the token, e.g. a running database query, can register a
+ * callback to be notified on cancellation.
  */
 struct CancellationToken
 {
@@ -41,8 +49,30 @@ public:
     bool isCancelled() const;
     void cancel();
 
+    /**
+     * @brief registerCallback
+     * Registers \a callback to be called once from the thread that cancels the token.
+     * If the token is already cancelled, \a callback is called immediately.
+     *
+     * Callbacks are called with the token locked. They must return quickly and must
+     * never use the token, e.g. cancel it, register or unregister callbacks,
+     * as that deadlocks.
+     * @return An id for unregisterCallback().
+     */
+    int registerCallback(const std::function<void()> &callback) const;
+
+    /// Unregisters a callback, waiting for it to return if it is being called.
+    void unregisterCallback(int id) const;
+
 private:
-    std::shared_ptr<bool> m_cancelled;
+    struct State {
+        std::atomic<bool> cancelled{false};
+        QMutex mutex;
+        int nextCallbackId = 0;
+        std::vector<std::pair<int, std::function<void()>>> callbacks;
+    };
+
+    std::shared_ptr<State> m_state;
 };
 
 }
@@ -1,4 +1,5 @@
 #include "dashtoc.h"
+#include "docset.h"
 #include "searchresult.h"
 
 #include <memory>
@@ -27,6 +28,7 @@ QList<SearchResult> DashToc::relatedLinks(const Docset *docset, const QUrl &url)
     if (jsonError.error != QJsonParseError::NoError)
         return QList<SearchResult>();
 
+    const std::shared_ptr<const Docset> sharedDocset = docset->shared_from_this();
     QList<SearchResult> results;
     QJsonArray entries = jsonObject[QStringLiteral("entries")].toArray();
     for (QJsonValue entry: entries) {
@@ -37,7 +39,7 @@ QList<SearchResult> DashToc::relatedLinks(const Docset *docset, const QUrl &url)
         QString path = entryObject[QStringLiteral("path")].toString();
 
         QString fullPath = fileName + "#" + QUrl::fromPercentEncoding(path.toUtf8());
-        results.append(SearchResult{name, "", entryType, const_cast<Docset*>(docset), fullPath, "", 0, isHeader});
+        results.append(SearchResult::fromStrings(sharedDocset, name, entryType, fullPath, 0, isHeader));
     }
 
     return results;
@@ -25,19 +25,31 @@
 #include "docset.h"
 #include "cachingsearchstrategy.h"
 #include "docsetsearchstrategy.h"
+#include "fuzzysearchstrategy.h"
+#include "indexedsearchstrategy.h"
 #include "searchresult.h"
+#include "searchscheduler.h"
+#include "searchstatistics.h"
+#include "sqliteinterrupter.h"
+#include "symbolindex.h"
+#include "toccache.h"
 
 #include "searchquery.h"
 #include "util/plist.h"
 
 #include <algorithm>
+#include <QAtomicInt>
+#include <QDateTime>
 #include <QDir>
 #include <QFile>
+#include <QHash>
 #include <QJsonDocument>
 #include <QJsonObject>
-#include <QRegularExpression>
+#include <QSet>
 #include <QSqlError>
 #include <QSqlQuery>
+#include <QThread>
+#include <QThreadStorage>
 #include <QUrl>
 #include <QVariant>
 
@@ -46,6 +58,64 @@ using namespace Zeal;
 namespace {
 const char IndexNamePrefix[] = "__zi_name"; // zi - Zeal index
 const char IndexNameVersion[] = "0001"; // Current index version
+const char SymbolIndexFileName[] = "docSet.zidx"; // Symbol index next to docSet.dsidx
+const int MmapSize = 256 * 1024 * 1024; // Map up to 256 MiB of the database file
+
+// Ids of docsets and threads, connection names are made of both
+QAtomicInt nextDocsetId;
+QAtomicInt nextThreadId;
+
+// Docsets destroyed while other threads may still have connections to them
+QMutex destroyedDocsetsMutex;
+QSet<int> destroyedDocsetIds;
+QAtomicInt destroyedDocsetCount;
+
+/**
+ * Connections opened by a thread, by docset id.
+ *
+ * Qt SQL connections may only be removed by the thread that uses them. They are
+ * removed when the thread finishes, or on the next database() call of the thread
+ * after their docset has been destroyed.
+ */
+struct ThreadConnections
+{
+    ~ThreadConnections()
+    {
+        for (const QString &name : names)
+            QSqlDatabase::removeDatabase(name);
+    }
+
+    void removeDestroyed()
+    {
+        const int count = destroyedDocsetCount.load();
+        if (count == seenDestroyedCount)
+            return;
+        seenDestroyedCount = count;
+
+        QMutexLocker locker(&destroyedDocsetsMutex);
+        for (auto it = names.begin(); it != names.end();) {
+            if (destroyedDocsetIds.contains(it.key())) {
+                QSqlDatabase::removeDatabase(it.value());
+                it = names.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    const int threadId = nextThreadId.fetchAndAddRelaxed(1);
+    int seenDestroyedCount = 0;
+    QHash<int, QString> names;
+};
+
+QThreadStorage<ThreadConnections *> threadConnections;
+
+ThreadConnections *currentThreadConnections()
+{
+    if (!threadConnections.hasLocalData())
+        threadConnections.setLocalData(new ThreadConnections());
+    return threadConnections.localData();
+}
 
 namespace InfoPlist {
 const char CFBundleName[] = "CFBundleName";
@@ -62,37 +132,68 @@ const char IsJavaScriptEnabled[] = "isJavaScriptEnabled";
 
 namespace Zeal {
 
+/**
+ * @brief The DashSearchStrategy class
+ * Searches the docset database directly, used while the symbol index is not available.
+ *
+ * In Subsequence mode symbols are matched with a LIKE pattern that has a
+ * wildcard between all query characters, and scored as fuzzy matches.
+ */
 class DashSearchStrategy : public DocsetSearchStrategy
 {
 public:
-    explicit DashSearchStrategy(Docset *docset);
+    enum class Mode {
+        Substring,
+        Subsequence
+    };
+
+    explicit DashSearchStrategy(Docset *docset, Mode mode = Mode::Substring);
     QList<SearchResult> search(const SearchQuery &searchQuery, CancellationToken token) override;
-    bool validResult(const SearchQuery &searchQuery, SearchResult previousResult,
-                     SearchResult &result) override;
 
 private:
+    QString likePattern(const SearchQuery &searchQuery) const;
+
     Docset *m_docset;
+    Mode m_mode;
 };
 
 }
 
-DashSearchStrategy::DashSearchStrategy(Docset *docset)
-    : m_docset(docset)
+DashSearchStrategy::DashSearchStrategy(Docset *docset, Mode mode)
+    : m_docset(docset),
+      m_mode(mode)
+{
+}
+
+QString DashSearchStrategy::likePattern(const SearchQuery &searchQuery) const
 {
+    if (m_mode == Mode::Substring)
+        return QLatin1Char('%') + searchQuery.sanitizedQuery() + QLatin1Char('%');
+
+    // "%q%s%t%" matches names containing q, s and t in this order
+    QString pattern(QLatin1Char('%'));
+    for (const QChar ch : searchQuery.query()) {
+        if (ch == QLatin1Char('\\') || ch == QLatin1Char('_') || ch == QLatin1Char('%'))
+            pattern += QLatin1Char('\\');
+        pattern += ch;
+        pattern += QLatin1Char('%');
+    }
+    return pattern;
 }
 
 QList<SearchResult> DashSearchStrategy::search(const SearchQuery &searchQuery, CancellationToken token)
 {
+    SearchStatistics::Timer timer(SearchStatistics::Stage::Sql);
     QList<SearchResult> results;
     int resultCount = 0;
 
-    const QString sanitizedQuery = searchQuery.sanitizedQuery();
+    const QString foldedQuery = searchQuery.foldedQuery();
 
-    QString queryStr;
+    // Read once, type() goes through open() and its mutex
+    const Docset::Type type = m_docset->type();
 
-    // Search all substrings
-    QString curQuery = QLatin1Char('%') + sanitizedQuery;
-    if (m_docset->type() == Docset::Type::Dash) {
+    QString queryStr;
+    if (type == Docset::Type::Dash) {
         queryStr = QString("SELECT name, type, path "
                            "    FROM searchIndex "
                            "WHERE (name LIKE :query ESCAPE '\\') ");
@@ -108,26 +209,40 @@ QList<SearchResult> DashSearchStrategy::search(const SearchQuery &searchQuery, C
                            "WHERE (ztokenname LIKE :query ESCAPE '\\') ");
     }
 
-    QSqlQuery query(m_docset->database());
+    const std::shared_ptr<const Docset> docset = m_docset->shared_from_this();
+    const QSqlDatabase db = m_docset->database();
+    const SqliteInterrupter interrupter(db, token);
+
+    QSqlQuery query(db);
     query.prepare(queryStr);
-    query.bindValue(":query", QString("%1%").arg(curQuery));
+    query.bindValue(":query", likePattern(searchQuery));
     query.exec();
 
     while (query.next() && !token.isCancelled() && resultCount < Docset::MaxDocsetResultsCount) {
         const QString itemName = query.value(0).toString();
         QString path = query.value(2).toString();
-        if (m_docset->type() == Docset::Type::ZDash) {
+        if (type == Docset::Type::ZDash) {
             const QString anchor = query.value(3).toString();
             if (!anchor.isEmpty())
                 path += QLatin1Char('#') + anchor;
         }
 
-        int score = Docset::scoreSubstringResult(searchQuery, itemName);
+        int score;
+        if (m_mode == Mode::Subsequence) {
+            // LIKE ignores case of ASCII characters only
+            const QString foldedName = SymbolIndex::foldCase(itemName);
+            score = FuzzySearchStrategy::score(itemName.constData(), foldedName.constData(),
+                                               itemName.size(), foldedQuery);
+            if (score < 0)
+                continue;
+        } else {
+            score = Docset::scoreSubstringResult(searchQuery, itemName);
+        }
         /// TODO: Third should be type
-        SearchResult newResult(SearchResult{itemName, QString(),
-                               m_docset->parseSymbolType(query.value(1).toString()),
-                               const_cast<Docset *>(m_docset),
-                               path, sanitizedQuery, score, false});
+        SearchResult newResult = SearchResult::fromStrings(
+                    docset, itemName,
+                    m_docset->parseSymbolType(query.value(1).toString()), path, score);
+        newResult.updateSortKey(searchQuery.query());
 
         results << newResult;
         resultCount++;
@@ -136,20 +251,8 @@ QList<SearchResult> DashSearchStrategy::search(const SearchQuery &searchQuery, C
     return results;
 }
 
-bool DashSearchStrategy::validResult(
-        const SearchQuery &searchQuery, SearchResult previousResult,
-        SearchResult &result)
-{
-    if (previousResult.name.contains(searchQuery.query(), Qt::CaseInsensitive)
-            && searchQuery.isEnabled(m_docset)) {
-        result = previousResult.withScore(Docset::scoreSubstringResult(searchQuery, previousResult.name));
-        return true;
-    } else {
-        return false;
-    }
-}
-
 Docset::Docset(const QString &path) :
+    m_id(nextDocsetId.fetchAndAddRelaxed(1)),
     m_path(path)
 {
     QDir dir(m_path);
@@ -157,9 +260,15 @@ Docset::Docset(const QString &path) :
         return;
 
     loadMetadata();
-    std::unique_ptr<DocsetSearchStrategy> strategy(new DashSearchStrategy(this));
+    std::unique_ptr<DocsetSearchStrategy> fallback(new DashSearchStrategy(this));
+    std::unique_ptr<DocsetSearchStrategy> strategy(new IndexedSearchStrategy(this, std::move(fallback)));
     m_searchStrategy = std::unique_ptr<DocsetSearchStrategy>(new CachingSearchStrategy(std::move(strategy)));
 
+    std::unique_ptr<DocsetSearchStrategy> fuzzyFallback(
+                new DashSearchStrategy(this, DashSearchStrategy::Mode::Subsequence));
+    std::unique_ptr<DocsetSearchStrategy> fuzzyStrategy(new FuzzySearchStrategy(this, std::move(fuzzyFallback)));
+    m_fuzzySearchStrategy = std::unique_ptr<DocsetSearchStrategy>(new CachingSearchStrategy(std::move(fuzzyStrategy)));
+
     // Attempt to find the icon in any supported format
     for (const QString &iconFile : dir.entryList({QStringLiteral("icon.*")}, QDir::Files)) {
         m_icon = QIcon(dir.absoluteFilePath(iconFile));
@@ -210,17 +319,8 @@ Docset::Docset(const QString &path) :
     if (!dir.cd(QStringLiteral("Resources")) || !dir.exists(QStringLiteral("docSet.dsidx")))
         return;
 
-    QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), m_name);
-    db.setDatabaseName(dir.absoluteFilePath(QStringLiteral("docSet.dsidx")));
-
-    if (!db.open()) {
-        qWarning("SQL Error: %s", qPrintable(db.lastError().text()));
-        return;
-    }
-
-    m_type = db.tables().contains(QStringLiteral("searchIndex")) ? Type::Dash : Type::ZDash;
-
-    createIndex();
+    // The database is opened by open() on first use, which the registry runs off the GUI thread
+    m_databasePath = dir.absoluteFilePath(QStringLiteral("docSet.dsidx"));
 
     if (!dir.cd(QStringLiteral("Documents")))
         return;
@@ -254,18 +354,35 @@ Docset::Docset(const QString &path) :
         else
             qWarning("Cannot determine index file for docset %s", qPrintable(m_name));
     }
-
-    countSymbols();
 }
 
 Docset::~Docset()
 {
-    QSqlDatabase::removeDatabase(m_name);
+    TocCache::instance()->remove(this);
+
+    // Connections of other threads are removed by those threads
+    {
+        QMutexLocker locker(&destroyedDocsetsMutex);
+        destroyedDocsetIds.insert(m_id);
+        destroyedDocsetCount.fetchAndAddOrdered(1);
+    }
+    if (threadConnections.hasLocalData())
+        threadConnections.localData()->removeDestroyed();
 }
 
 bool Docset::isValid() const
 {
-    return m_type != Type::Invalid;
+    if (m_databasePath.isEmpty())
+        return false;
+
+    // A database that cannot be read is only found out once it is open
+    return !isOpen() || m_type != Type::Invalid;
+}
+
+/// Does not wait for an open() in progress, so it can be called on the GUI thread.
+bool Docset::isOpen() const
+{
+    return m_isOpenFinished.loadAcquire();
 }
 
 QString Docset::name() const
@@ -310,50 +427,120 @@ QString Docset::indexFilePath() const
 
 Docset::Type Docset::type() const
 {
+    open();
     return m_type;
 }
 
 QMap<QString, int> Docset::symbolCounts() const
 {
+    open();
     return m_symbolCounts;
 }
 
 int Docset::symbolCount(const QString &symbolType) const
 {
+    open();
     return m_symbolCounts.value(symbolType);
 }
 
-const QMap<QString, QString> &Docset::symbols(const QString &symbolType) const
+Docset::Symbol Docset::symbol(const QString &symbolType, int index) const
 {
-    if (!m_symbols.contains(symbolType))
-        loadSymbols(symbolType);
-    return m_symbols[symbolType];
+    open();
+
+    const int page = index / SymbolPageSize;
+    TocCache::Page symbols = TocCache::instance()->find(this, symbolType, page);
+    if (!symbols) {
+        symbols = loadSymbolPages(symbolType, page);
+        if (!symbols)
+            return Symbol();
+    }
+
+    const int offset = index % SymbolPageSize;
+    return offset < symbols->size() ? symbols->at(offset) : Symbol();
 }
 
-bool Docset::endsWithSeparator(QString result, int pos)
+/**
+ * @brief Docset::loadSymbolPages
+ * Pages continue from the last symbol of the previous page, so loading starts after the nearest
+ * cached page before \a page, and every page read on the way is cached as well. A page that failed
+ * to load is not cached, so it is read again next time. Returns null on failure.
+ */
+std::shared_ptr<const QVector<Docset::Symbol>> Docset::loadSymbolPages(const QString &symbolType, int page) const
 {
-    QString beforeMatch = result.mid(0, pos);
-    return beforeMatch.endsWith(".") || beforeMatch.endsWith("::") || beforeMatch.endsWith("/");
+    TocCache *cache = TocCache::instance();
+
+    int nextPage = page;
+    TocCache::Page previousSymbols;
+    while (nextPage > 0 && !previousSymbols)
+        previousSymbols = cache->find(this, symbolType, --nextPage);
+    if (previousSymbols)
+        ++nextPage;
+
+    TocCache::Page symbols;
+    for (; nextPage <= page; ++nextPage) {
+        // Past the last symbol every page is empty
+        if (previousSymbols && previousSymbols->isEmpty())
+            return previousSymbols;
+
+        QVector<Symbol> loadedSymbols;
+        if (!loadSymbolPage(symbolType, previousSymbols ? &previousSymbols->last() : nullptr, &loadedSymbols))
+            return nullptr;
+
+        symbols = cache->insert(this, symbolType, nextPage, loadedSymbols);
+        previousSymbols = symbols;
+    }
+
+    return symbols;
 }
 
-int Docset::separators(QString result, int pos)
+bool Docset::endsWithSeparator(const QString &result, int pos)
 {
-    QRegularExpression separator("\\.|::|/");
-    return result.mid(0, pos).count(separator);
+    if (pos <= 0)
+        return false;
+
+    const QChar last = result.at(pos - 1);
+    return last == QLatin1Char('.') || last == QLatin1Char('/')
+            || (last == QLatin1Char(':') && pos > 1 && result.at(pos - 2) == QLatin1Char(':'));
 }
 
-int Docset::scoreSubstringResult(const SearchQuery &query, const QString result)
+/// Counts ".", "::" and "/" separators before \a pos, matching them from left to right.
+int Docset::separators(const QString &result, int pos)
 {
-    int score = TotalBuckets - 1;
-
-    int index = result.indexOf(query.query(), 0, Qt::CaseInsensitive);
-    if (index == 0 || Docset::endsWithSeparator(result, index)) {
-        score -= result.size() - query.query().size() - index + Docset::separators(result, index);
-    } else {
-        score -= result.size() - query.query().size() + 2;
+    int count = 0;
+    for (int i = 0; i < pos; ++i) {
+        const QChar ch = result.at(i);
+        if (ch == QLatin1Char('.') || ch == QLatin1Char('/')) {
+            ++count;
+        } else if (ch == QLatin1Char(':') && i + 1 < pos && result.at(i + 1) == QLatin1Char(':')) {
+            ++count;
+            ++i;
+        }
     }
+    return count;
+}
 
-    return std::max(1, score);
+/// Scoring kernel shared by string and indexed results.
+int Docset::scoreMatch(int resultSize, int querySize, int pos, bool afterSeparator, int separatorCount)
+{
+    // Matches at the start or right after a separator are penalized by the separators before them
+    const bool isAnchored = pos == 0 || afterSeparator;
+    const int penalty = isAnchored ? separatorCount - pos : 2;
+    return std::max(1, TotalBuckets - 1 - (resultSize - querySize + penalty));
+}
+
+int Docset::scoreSubstringResult(const SearchQuery &query, const QString &result)
+{
+    const int pos = result.indexOf(query.query(), 0, Qt::CaseInsensitive);
+    const bool afterSeparator = endsWithSeparator(result, pos);
+    return scoreMatch(result.size(), query.query().size(), pos, afterSeparator,
+                      afterSeparator ? separators(result, pos) : 0);
+}
+
+int Docset::scoreSubstringResult(const SearchQuery &query, const SymbolIndex *index, int id)
+{
+    const int pos = index->indexOf(id, query.foldedQuery());
+    return scoreMatch(index->nameLength(id), query.query().size(), pos,
+                      index->endsWithSeparator(id, pos), index->separatorCount(id, pos));
 }
 
 QList<SearchResult> Docset::search(const SearchQuery &searchQuery, CancellationToken token) const
@@ -361,9 +548,34 @@ QList<SearchResult> Docset::search(const SearchQuery &searchQuery, CancellationT
     if (!searchQuery.isEnabled(this))
         return QList<SearchResult>();
 
+    if (searchQuery.isFuzzy())
+        return m_fuzzySearchStrategy->search(searchQuery, token);
     return m_searchStrategy->search(searchQuery, token);
 }
 
+const SymbolIndex *Docset::symbolIndex() const
+{
+    QMutexLocker locker(&m_symbolIndexMutex);
+    if (m_symbolIndexState != SymbolIndexState::NotLoaded)
+        return m_symbolIndex.get();
+
+    m_symbolIndex = SymbolIndex::open(symbolIndexFilePath(), symbolIndexKey());
+    if (m_symbolIndex) {
+        m_symbolIndexState = SymbolIndexState::Ready;
+    } else {
+        // Searches go through SQLite until the index is ready. The build only keeps the
+        // docset alive while it runs, a build still queued when the docset is destroyed is dropped.
+        m_symbolIndexState = SymbolIndexState::Building;
+        const std::weak_ptr<const Docset> docset = shared_from_this();
+        SearchScheduler::instance()->run(SearchScheduler::Priority::Background, [docset]() {
+            if (const std::shared_ptr<const Docset> sharedDocset = docset.lock())
+                sharedDocset->updateSymbolIndex();
+        });
+    }
+
+    return m_symbolIndex.get();
+}
+
 QList<SearchResult> Docset::relatedLinks(const QUrl &url) const
 {
     // Try to read the .dashtoc file first since it has more accurate related links.
@@ -373,6 +585,8 @@ QList<SearchResult> Docset::relatedLinks(const QUrl &url) const
 
     QList<SearchResult> results;
 
+    open();
+
     // Strip docset path and anchor from url
     const QString dir = documentPath();
     QString urlPath = url.path();
@@ -407,9 +621,9 @@ QList<SearchResult> Docset::relatedLinks(const QUrl &url) const
             sectionPath += query.value(3).toString();
         }
 
-        results.append(SearchResult{sectionName, QString(),
-                                    parseSymbolType(query.value(1).toString()),
-                                    const_cast<Docset *>(this), sectionPath, QString(), 0, false});
+        results.append(SearchResult::fromStrings(shared_from_this(), sectionName,
+                                                 parseSymbolType(query.value(1).toString()),
+                                                 sectionPath));
     }
 
     if (results.size() == 1)
@@ -420,7 +634,92 @@ QList<SearchResult> Docset::relatedLinks(const QUrl &url) const
 
 QSqlDatabase Docset::database() const
 {
-    return QSqlDatabase::database(m_name, true);
+    open();
+
+    ThreadConnections *connections = currentThreadConnections();
+    connections->removeDestroyed();
+
+    const QString connectionName = connections->names.value(m_id);
+    if (!connectionName.isEmpty())
+        return QSqlDatabase::database(connectionName, false);
+
+    return addThreadConnection(QStringLiteral("docset%1/thread%2").arg(m_id).arg(connections->threadId));
+}
+
+/// Called on first use of anything that needs symbols, see DocsetRegistry::openDocset().
+bool Docset::open() const
+{
+    QMutexLocker locker(&m_openMutex);
+    if (!m_isOpen) {
+        // Set early, helpers below get the connection through database()
+        m_isOpen = true;
+        openDatabase();
+        m_isOpenFinished.storeRelease(1);
+    }
+
+    return m_type != Type::Invalid;
+}
+
+void Docset::openDatabase() const
+{
+    // Creating the index needs a writable connection, it is closed right after
+    const QString connectionName = QStringLiteral("docset%1").arg(m_id);
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), connectionName);
+        db.setDatabaseName(m_databasePath);
+
+        if (!db.open()) {
+            qWarning("SQL Error: %s", qPrintable(db.lastError().text()));
+            db = QSqlDatabase();
+            QSqlDatabase::removeDatabase(connectionName);
+            return;
+        }
+
+        const QStringList tables = db.tables();
+        if (tables.contains(QStringLiteral("searchIndex")))
+            m_type = Type::Dash;
+        else if (tables.contains(QStringLiteral("ztoken"), Qt::CaseInsensitive))
+            m_type = Type::ZDash;
+
+        createIndex(db);
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+
+    if (m_type == Type::Invalid || !countSymbols()) {
+        qWarning("Cannot read database of docset %s", qPrintable(m_name));
+        m_type = Type::Invalid;
+    }
+}
+
+/**
+ * @brief Docset::addThreadConnection
+ * Opens a read-only connection for the current thread.
+ *
+ * Qt SQL connections must not be shared between threads. Searches run on
+ * pool threads, so each of them gets its own connection. The thread removes
+ * it when it finishes, or on its next database() call after the docset is destroyed.
+ */
+QSqlDatabase Docset::addThreadConnection(const QString &connectionName) const
+{
+    QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), connectionName);
+    db.setDatabaseName(m_databasePath);
+    db.setConnectOptions(QStringLiteral("QSQLITE_OPEN_READONLY;QSQLITE_ENABLE_SHARED_CACHE"));
+
+    // A connection that failed to open is dropped, so that the next database() call retries
+    if (!db.open()) {
+        qWarning("SQL Error: %s", qPrintable(db.lastError().text()));
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(connectionName);
+        return QSqlDatabase();
+    }
+
+    currentThreadConnections()->names.insert(m_id, connectionName);
+
+    QSqlQuery query(db);
+    query.exec(QStringLiteral("PRAGMA mmap_size = %1").arg(MmapSize));
+
+    return db;
 }
 
 void Docset::loadMetadata()
@@ -452,7 +751,7 @@ void Docset::loadMetadata()
     }
 }
 
-void Docset::countSymbols()
+bool Docset::countSymbols() const
 {
     QString queryStr;
     if (m_type == Docset::Type::Dash) {
@@ -465,7 +764,7 @@ void Docset::countSymbols()
     QSqlQuery query(queryStr, database());
     if (query.lastError().type() != QSqlError::NoError) {
         qWarning("SQL Error: %s", qPrintable(query.lastError().text()));
-        return;
+        return false;
     }
 
     while (query.next()) {
@@ -475,54 +774,94 @@ void Docset::countSymbols()
         m_symbolCounts[symbolType] += query.value(1).toInt();
         m_symbolsTotal += query.value(1).toInt();
     }
-}
 
-/// TODO: Fetch and cache only portions of symbols
-void Docset::loadSymbols(const QString &symbolType) const
-{
-    for (const QString &symbol : m_symbolStrings.values(symbolType))
-        loadSymbols(symbolType, symbol);
+    return query.lastError().type() == QSqlError::NoError;
 }
 
-void Docset::loadSymbols(const QString &symbolType, const QString &symbolString) const
+/**
+ * @brief Docset::loadSymbolPage
+ * Loads up to SymbolPageSize symbols of all type strings that map to \a symbolType, sorted by name.
+ * The page starts after \a previous, the last symbol of the previous page, or at the first symbol
+ * if it is null. The range is read from the name index, so no query sorts a whole group.
+ * Returns false if the database cannot be read.
+ */
+bool Docset::loadSymbolPage(const QString &symbolType, const Symbol *previous, QVector<Symbol> *symbols) const
 {
+    symbols->clear();
+
+    const QStringList symbolStrings = m_symbolStrings.values(symbolType);
+    if (symbolStrings.isEmpty())
+        return true;
+
     QSqlDatabase db = database();
     if (!db.isOpen())
-        return;
+        return false;
 
+    QStringList placeholders;
+    for (int i = 0; i < symbolStrings.size(); ++i)
+        placeholders << QStringLiteral("?");
+
+    // Ties are ordered by row id, so pages neither overlap nor skip symbols
     QString queryStr;
     if (m_type == Docset::Type::Dash) {
-        queryStr = QStringLiteral("SELECT name, path FROM searchIndex WHERE type='%1' ORDER BY name ASC");
+        queryStr = QStringLiteral("SELECT rowid, name, path FROM searchIndex WHERE type IN (%1)"
+                                  " AND name >= ? COLLATE NOCASE"
+                                  " AND (name > ? COLLATE NOCASE OR rowid > ?)"
+                                  " ORDER BY name COLLATE NOCASE, rowid LIMIT %2");
     } else {
-        queryStr = QStringLiteral("SELECT ztokenname AS name, "
+        queryStr = QStringLiteral("SELECT ztoken.z_pk, ztokenname, "
                                   "CASE WHEN (zanchor IS NULL) THEN zpath "
                                   "ELSE (zpath || '#' || zanchor) "
                                   "END AS path FROM ztoken "
                                   "JOIN ztokenmetainformation ON ztoken.zmetainformation = ztokenmetainformation.z_pk "
                                   "JOIN zfilepath ON ztokenmetainformation.zfile = zfilepath.z_pk "
-                                  "JOIN ztokentype ON ztoken.ztokentype = ztokentype.z_pk WHERE ztypename='%1' "
-                                  "ORDER BY ztokenname ASC");
+                                  "JOIN ztokentype ON ztoken.ztokentype = ztokentype.z_pk WHERE ztypename IN (%1) "
+                                  "AND ztokenname >= ? COLLATE NOCASE "
+                                  "AND (ztokenname > ? COLLATE NOCASE OR ztoken.z_pk > ?) "
+                                  "ORDER BY ztokenname COLLATE NOCASE, ztoken.z_pk LIMIT %2");
+    }
+
+    const QString previousName = previous ? previous->name : QString(QLatin1String(""));
+    const qint64 previousId = previous ? previous->id : -1;
+
+    QSqlQuery query(db);
+    query.prepare(queryStr.arg(placeholders.join(QStringLiteral(", "))).arg(SymbolPageSize));
+    for (const QString &symbolString : symbolStrings)
+        query.addBindValue(symbolString);
+    query.addBindValue(previousName);
+    query.addBindValue(previousName);
+    query.addBindValue(previousId);
+
+    if (!query.exec()) {
+        qWarning("SQL Error: %s", qPrintable(query.lastError().text()));
+        return false;
+    }
+
+    symbols->reserve(SymbolPageSize);
+    while (query.next()) {
+        Symbol symbol;
+        symbol.id = query.value(0).toLongLong();
+        symbol.name = query.value(1).toString();
+        symbol.path = query.value(2).toString();
+        symbols->append(symbol);
     }
 
-    QSqlQuery query(queryStr.arg(symbolString), database());
     if (query.lastError().type() != QSqlError::NoError) {
         qWarning("SQL Error: %s", qPrintable(query.lastError().text()));
-        return;
+        return false;
     }
 
-    QMap<QString, QString> &symbols = m_symbols[symbolType];
-    while (query.next())
-        symbols.insertMulti(query.value(0).toString(), QDir(documentPath()).absoluteFilePath(query.value(1).toString()));
+    return true;
 }
 
-void Docset::createIndex()
+void Docset::createIndex(const QSqlDatabase &db) const
 {
     static const QString indexListQuery = QStringLiteral("PRAGMA INDEX_LIST('%1')");
     static const QString indexDropQuery = QStringLiteral("DROP INDEX '%1'");
     static const QString indexCreateQuery = QStringLiteral("CREATE INDEX IF NOT EXISTS %1%2"
-                                                           " ON %3 (name COLLATE NOCASE)");
+                                                           " ON %3 (%4 COLLATE NOCASE)");
 
-    QSqlQuery query(database());
+    QSqlQuery query(db);
 
     const QString tableName = m_type == Type::Dash ? QStringLiteral("searchIndex")
                                                    : QStringLiteral("ztoken");
@@ -546,7 +885,87 @@ void Docset::createIndex()
     for (const QString oldIndexName : oldIndexes)
         query.exec(indexDropQuery.arg(oldIndexName));
 
-    query.exec(indexCreateQuery.arg(IndexNamePrefix, IndexNameVersion, tableName));
+    // Symbol pages are read in name order from this index
+    const QString columnName = m_type == Type::Dash ? QStringLiteral("name")
+                                                    : QStringLiteral("ztokenname");
+    query.exec(indexCreateQuery.arg(IndexNamePrefix, IndexNameVersion, tableName, columnName));
+}
+
+std::unique_ptr<SymbolIndex> Docset::buildSymbolIndex() const
+{
+    open();
+
+    QString queryStr;
+    if (m_type == Docset::Type::Dash) {
+        queryStr = QStringLiteral("SELECT name, type, path FROM searchIndex");
+    } else if (m_type == Docset::Type::ZDash) {
+        queryStr = QStringLiteral("SELECT ztokenname, ztypename, zpath, zanchor "
+                                  "FROM ztoken "
+                                  "JOIN ztokenmetainformation ON ztoken.zmetainformation = ztokenmetainformation.z_pk "
+                                  "JOIN zfilepath ON ztokenmetainformation.zfile = zfilepath.z_pk "
+                                  "JOIN ztokentype ON ztoken.ztokentype = ztokentype.z_pk");
+    }
+
+    QSqlQuery query(queryStr, database());
+    if (query.lastError().type() != QSqlError::NoError) {
+        qWarning("SQL Error: %s", qPrintable(query.lastError().text()));
+        return nullptr;
+    }
+
+    SymbolIndex::Builder builder;
+    while (query.next()) {
+        QString path = query.value(2).toString();
+        if (m_type == Docset::Type::ZDash) {
+            const QString anchor = query.value(3).toString();
+            if (!anchor.isEmpty())
+                path += QLatin1Char('#') + anchor;
+        }
+
+        builder.addSymbol(query.value(0).toString(), parseSymbolType(query.value(1).toString()), path);
+    }
+
+    return builder.build(symbolIndexKey());
+}
+
+void Docset::updateSymbolIndex() const
+{
+    const QString fileName = symbolIndexFilePath();
+    std::unique_ptr<SymbolIndex> index = buildSymbolIndex();
+
+    // Prefer the mapped file to keep the index out of the process heap. Later runs only check
+    // its sections, so it is verified in full once here, and dropped if it was not written intact.
+    if (index && index->save(fileName)) {
+        std::unique_ptr<SymbolIndex> mappedIndex = SymbolIndex::open(fileName, index->key(),
+                                                                     SymbolIndex::Verification::Full);
+        if (mappedIndex) {
+            index = std::move(mappedIndex);
+        } else {
+            qWarning("Cannot verify symbol index for docset %s", qPrintable(m_name));
+            QFile::remove(fileName);
+        }
+    } else if (index) {
+        qWarning("Cannot save symbol index for docset %s", qPrintable(m_name));
+    }
+
+    QMutexLocker locker(&m_symbolIndexMutex);
+    m_symbolIndex = std::move(index);
+    m_symbolIndexState = m_symbolIndex ? SymbolIndexState::Ready : SymbolIndexState::Failed;
+}
+
+QString Docset::symbolIndexFilePath() const
+{
+    return QDir(m_path).absoluteFilePath(QStringLiteral("Contents/Resources/")
+                                         + QLatin1String(SymbolIndexFileName));
+}
+
+/// The symbol index is rebuilt when the index version, the docset revision,
+/// or the docset database changes.
+QString Docset::symbolIndexKey() const
+{
+    const QFileInfo fileInfo(m_databasePath);
+    return QStringLiteral("%1%2/%3/%4/%5/%6").arg(IndexNamePrefix, IndexNameVersion, m_version, m_revision,
+                                                  QString::number(fileInfo.size()),
+                                                  QString::number(fileInfo.lastModified().toMSecsSinceEpoch()));
 }
 
 QString Docset::parseSymbolType(const QString &str)
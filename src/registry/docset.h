@@ -31,25 +31,33 @@
 #include <QIcon>
 #include <QMap>
 #include <QMetaObject>
+#include <QMutex>
 #include <QSqlDatabase>
+#include <QVector>
 
 namespace Zeal {
 
 class DocsetSearchStrategy;
 class SearchQuery;
 struct SearchResult;
+class SymbolIndex;
 
 /**
  * @brief The Docset class
- * A single docset.
+ * A single docset, always owned by a std::shared_ptr that search results share.
  */
-class Docset
+class Docset : public std::enable_shared_from_this<Docset>
 {
 public:
     explicit Docset(const QString &path);
     ~Docset();
 
+    /// Returns false if the docset has no database, or once open() found it unreadable.
     bool isValid() const;
+    bool isOpen() const;
+    /// Opens the database and counts symbols unless it has been done already.
+    /// Returns false if the database cannot be read, the docset is invalid then.
+    bool open() const;
 
     QString name() const;
     QString title() const;
@@ -65,15 +73,27 @@ public:
     QMap<QString, int> symbolCounts() const;
     int symbolCount(const QString &symbolType) const;
 
-    const QMap<QString, QString> &symbols(const QString &symbolType) const;
+    /// A ToC entry, the path is relative to documentPath().
+    struct Symbol {
+        qint64 id = -1; // Row id, the next page starts after the last symbol of a page
+        QString name;
+        QString path;
+    };
+
+    /// Returns symbol \a index of \a symbolType in name order, its page is loaded into TocCache on demand.
+    Symbol symbol(const QString &symbolType, int index) const;
 
     QList<SearchResult> search(const SearchQuery &searchQuery, CancellationToken token) const;
     QList<SearchResult> relatedLinks(const QUrl &url) const;
 
+    /// Returns the symbol index, or nullptr while it is being built in background or if the build failed.
+    const SymbolIndex *symbolIndex() const;
+
     /// FIXME: This is an ugly workaround before we have a proper docset sources implementation
     bool hasUpdate = false;
     const static int MaxDocsetResultsCount = 500;
     const static int TotalBuckets = 20;
+    const static int SymbolPageSize = 512;
 
     enum class Type {
         Invalid,
@@ -84,38 +104,67 @@ public:
     QSqlDatabase database() const;
 
     static QString parseSymbolType(const QString &str);
-    static int scoreSubstringResult(const SearchQuery &query, const QString result);
+    static int scoreSubstringResult(const SearchQuery &query, const QString &result);
+    /// Scores a symbol of \a index using its precomputed separators, without allocating.
+    static int scoreSubstringResult(const SearchQuery &query, const SymbolIndex *index, int id);
 
     Docset::Type type() const;
 
 private:
     void loadMetadata();
-    void countSymbols();
-    void loadSymbols(const QString &symbolType) const;
-    void loadSymbols(const QString &symbolType, const QString &symbolString) const;
-    void createIndex();
-
-    static bool endsWithSeparator(QString result, int pos);
-    static int separators(QString result, int pos);
-
+    void openDatabase() const;
+    bool countSymbols() const;
+    bool loadSymbolPage(const QString &symbolType, const Symbol *previous, QVector<Symbol> *symbols) const;
+    std::shared_ptr<const QVector<Symbol>> loadSymbolPages(const QString &symbolType, int page) const;
+    void createIndex(const QSqlDatabase &db) const;
+    QSqlDatabase addThreadConnection(const QString &connectionName) const;
+    std::unique_ptr<SymbolIndex> buildSymbolIndex() const;
+    void updateSymbolIndex() const;
+    QString symbolIndexFilePath() const;
+    QString symbolIndexKey() const;
+
+    static bool endsWithSeparator(const QString &result, int pos);
+    static int separators(const QString &result, int pos);
+    static int scoreMatch(int resultSize, int querySize, int pos, bool afterSeparator, int separatorCount);
+
+    // Unique among all docsets, even of the same name, connection names contain it
+    const int m_id;
     QString m_sourceId;
     QString m_name;
     QString m_title;
     QStringList m_keywords;
     QString m_version;
     QString m_revision;
-    Docset::Type m_type = Type::Invalid;
     QString m_path;
     QIcon m_icon;
 
     QString m_indexFilePath;
+    QString m_databasePath;
+
+    // Materialized by open() on first use
+    mutable QMutex m_openMutex{QMutex::Recursive};
+    mutable bool m_isOpen = false;
+    // Set once open() has finished, read without locking m_openMutex
+    mutable QAtomicInt m_isOpenFinished;
+    mutable Docset::Type m_type = Type::Invalid;
+    mutable QMap<QString, QString> m_symbolStrings;
+    mutable QMap<QString, int> m_symbolCounts;
+    mutable uint64_t m_symbolsTotal = 0;
+
+
+    enum class SymbolIndexState {
+        NotLoaded,
+        Building,
+        Ready,
+        Failed
+    };
 
-    QMap<QString, QString> m_symbolStrings;
-    QMap<QString, int> m_symbolCounts;
-    mutable QMap<QString, QMap<QString, QString>> m_symbols;
-    uint64_t m_symbolsTotal;
+    mutable QMutex m_symbolIndexMutex;
+    mutable std::unique_ptr<SymbolIndex> m_symbolIndex;
+    mutable SymbolIndexState m_symbolIndexState = SymbolIndexState::NotLoaded;
 
     std::unique_ptr<DocsetSearchStrategy> m_searchStrategy;
+    std::unique_ptr<DocsetSearchStrategy> m_fuzzySearchStrategy;
 };
 
 } // namespace Zeal
@@ -25,26 +25,104 @@
 
 #include "docset.h"
 
+#include <QHash>
+#include <QMap>
+#include <QVector>
+
 using namespace Zeal;
 
-void DocsetKeywords::add(QString &keywordStr, Docset *docset)
+namespace Zeal {
+
+struct DocsetKeywords::Data : public QSharedData
+{
+    QVector<std::shared_ptr<Docset>> docsets;
+    QHash<const Docset *, int> indexes;
+    QHash<QString, int> indexesByName;
+    QMap<QString, QBitArray> keywords;
+};
+
+} // namespace Zeal
+
+DocsetKeywords::DocsetKeywords() :
+    d(new Data())
 {
-    QStringList docsets;
-    docsets << docset->name();
-    m_keywords.insert(keywordStr.toLower(), docsets);
 }
 
-void DocsetKeywords::add(QString &keywordStr, QStringList docsetGroup)
+DocsetKeywords::DocsetKeywords(const QList<std::shared_ptr<Docset>> &docsets) :
+    d(new Data())
 {
-    m_keywords.insert(keywordStr.toLower(), docsetGroup);
+    for (const std::shared_ptr<Docset> &docset : docsets) {
+        d->indexes.insert(docset.get(), d->docsets.size());
+        d->indexesByName.insert(docset->name(), d->docsets.size());
+        d->docsets.append(docset);
+    }
 }
 
-QStringList DocsetKeywords::getKeywordDocsets(QString &keywordStr) const
+DocsetKeywords::DocsetKeywords(const DocsetKeywords &other) :
+    d(other.d)
 {
-    return m_keywords.value(keywordStr.toLower());
+}
+
+DocsetKeywords::~DocsetKeywords()
+{
+}
+
+DocsetKeywords &DocsetKeywords::operator=(const DocsetKeywords &other)
+{
+    d = other.d;
+    return *this;
+}
+
+void DocsetKeywords::add(const QString &keywordStr, const Docset *docset)
+{
+    QBitArray docsets(d->docsets.size());
+    const int index = d->indexes.value(docset, -1);
+    if (index != -1)
+        docsets.setBit(index);
+    d->keywords.insert(keywordStr.toLower(), docsets);
+}
+
+void DocsetKeywords::add(const QString &keywordStr, const QStringList &docsetGroup)
+{
+    // An empty group does not define a keyword
+    if (docsetGroup.isEmpty())
+        return;
+
+    QBitArray docsets(d->docsets.size());
+    for (const QString &name : docsetGroup) {
+        const int index = d->indexesByName.value(name, -1);
+        if (index != -1)
+            docsets.setBit(index);
+    }
+    d->keywords.insert(keywordStr.toLower(), docsets);
+}
+
+bool DocsetKeywords::contains(const QString &keywordStr) const
+{
+    return d->keywords.contains(keywordStr.toLower());
+}
+
+QBitArray DocsetKeywords::getKeywordDocsets(const QString &keywordStr) const
+{
+    return d->keywords.value(keywordStr.toLower());
 }
 
 QStringList DocsetKeywords::getKeywords() const
 {
-    return m_keywords.keys();
+    return d->keywords.keys();
+}
+
+int DocsetKeywords::docsetCount() const
+{
+    return d->docsets.size();
+}
+
+std::shared_ptr<Docset> DocsetKeywords::docset(int index) const
+{
+    return d->docsets.at(index);
+}
+
+int DocsetKeywords::indexOf(const Docset *docset) const
+{
+    return d->indexes.value(docset, -1);
 }
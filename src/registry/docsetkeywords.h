@@ -24,7 +24,10 @@
 #ifndef DOCSETKEYWORDS_H
 #define DOCSETKEYWORDS_H
 
-#include <QMap>
+#include <memory>
+#include <QBitArray>
+#include <QList>
+#include <QSharedDataPointer>
 #include <QString>
 #include <QStringList>
 
@@ -41,30 +44,45 @@ class Docset;
  *    For example keyword `cpp` is most likely mapped to a cpp docset.
  * 2. Group keywords are used to search for multiple docsets.
  *    For example keyword `web` might be mapped to `html`, `js` and `css` docsets.
+ *
+ * Every docset passed to the constructor is given an index, and keywords are
+ * compiled to bitsets of docset indexes, so docsets of several keywords are
+ * combined with a single OR. Indexed docsets are kept alive as long as any
+ * copy exists, and copies share the data.
  */
 class DocsetKeywords
 {
 public:
+    DocsetKeywords();
+    explicit DocsetKeywords(const QList<std::shared_ptr<Docset>> &docsets);
+    DocsetKeywords(const DocsetKeywords &other);
+    ~DocsetKeywords();
+    DocsetKeywords &operator=(const DocsetKeywords &other);
+
     /**
      * @brief add
      * Adds a keyword under which a single docset should be searched.
      */
-    void add(QString &keywordStr, Docset *docset);
+    void add(const QString &keywordStr, const Docset *docset);
 
     /**
      * @brief add
      * Adds a keyword under which an entire group should be searched.
+     * Names of docsets that are not installed are ignored.
      */
-    void add(QString &keywordStr, QStringList docsetGroup);
+    void add(const QString &keywordStr, const QStringList &docsetGroup);
+
+    /// Returns true if the keyword is defined.
+    bool contains(const QString &keywordStr) const;
 
     /**
      * @brief getKeywordDocsets
-     * Returns matching list of docsets mapped to a keyword.
+     * Returns docsets mapped to a keyword as a bitset of docset indexes.
      *
      * @param keywordStr Keyword to search for.
-     * @return QList() if the keyword is not defined. Matching list of docsets otherwise.
+     * @return QBitArray() if the keyword is not defined. Matching docsets otherwise.
      */
-    QStringList getKeywordDocsets(QString &keywordStr) const;
+    QBitArray getKeywordDocsets(const QString &keywordStr) const;
 
     /**
      * @brief getKeywords
@@ -72,8 +90,14 @@ public:
      */
     QStringList getKeywords() const;
 
+    int docsetCount() const;
+    std::shared_ptr<Docset> docset(int index) const;
+    /// Returns the index of \a docset, or -1 if it is unknown.
+    int indexOf(const Docset *docset) const;
+
 private:
-    QMap<QString, QStringList> m_keywords;
+    struct Data;
+    QSharedDataPointer<Data> d;
 };
 
 }
@@ -26,21 +26,90 @@
 #include "docsetkeywords.h"
 #include "searchquery.h"
 #include "searchresult.h"
+#include "searchscheduler.h"
+#include "searchstatistics.h"
+#include "symbolindex.h"
 
+#include <algorithm>
 #include <functional>
-#include <QtConcurrent/QtConcurrent>
 #include <QDir>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QHash>
 #include <QSqlQuery>
 #include <QThread>
+#include <QTimer>
 #include <QUrl>
 #include <QVariant>
 
 using namespace Zeal;
 
+namespace {
+// Queries are dispatched right away while searches take less than this, in milliseconds
+const qint64 FastSearchDuration = 30;
+// Longest time a query waits for running searches, in milliseconds
+const qint64 MaxDispatchDelay = 150;
+// Number of likely next characters searched in advance
+const int PrefetchCharacterCount = 3;
+
+class DocsetLoader : public QRunnable
+{
+public:
+    typedef std::function<void(Docset *docset, int generation)> Callback;
+
+    DocsetLoader(const QString &path, int generation, const Callback &callback) :
+        m_path(path),
+        m_generation(generation),
+        m_callback(callback)
+    {
+    }
+
+    void run() override
+    {
+        // Only metadata is read, the database is opened on first use
+        m_callback(new Docset(m_path), m_generation);
+    }
+
+private:
+    QString m_path;
+    int m_generation;
+    Callback m_callback;
+};
+
+// State of a query shared by the watchers of its docset searches.
+struct QueryState
+{
+    CancellationToken token;
+    SearchQuery searchQuery;
+    QList<std::shared_ptr<Docset>> docsets;
+    int pendingCount = 0;
+    bool isFirstBatch = true;
+    QList<SearchResult> results;
+    QElapsedTimer timer;
+};
+}
+
+/// Docsets waiting to be destroyed on the registry thread.
+struct DocsetRegistry::ReleaseQueue
+{
+    QMutex mutex;
+    // Reset once the registry thread stopped, docsets are destroyed right away then
+    DocsetRegistry *registry = nullptr;
+    QList<Docset *> docsets;
+};
+
 DocsetRegistry::DocsetRegistry(QObject *parent) :
     QObject(parent),
-    m_thread(new QThread(this))
+    m_thread(new QThread(this)),
+    m_releaseQueue(new ReleaseQueue()),
+    m_docsets(new DocsetTable()),
+    m_dispatchTimer(new QTimer(this))
 {
+    m_releaseQueue->registry = this;
+
+    m_dispatchTimer->setSingleShot(true);
+    connect(m_dispatchTimer, &QTimer::timeout, this, &DocsetRegistry::_runPendingQuery);
+
     /// FIXME: Only search should be performed in a separate thread
     moveToThread(m_thread.get());
     m_thread->start();
@@ -48,32 +117,73 @@ DocsetRegistry::DocsetRegistry(QObject *parent) :
 
 DocsetRegistry::~DocsetRegistry()
 {
+    m_loaderGeneration.fetchAndAddOrdered(1);
+    m_loaderPool.waitForDone();
     m_thread->exit();
     m_thread->wait();
-    qDeleteAll(m_docsets);
+
+    // No query or prefetch starts once the registry thread has stopped. Tasks still
+    // hold docsets, so they must finish while the caches used by ~Docset exist.
+    waitForPrefetch();
+    SearchScheduler::instance()->shutdown();
+
+    // Docsets handed over after the registry thread stopped are never added
+    {
+        QMutexLocker locker(&m_loadedDocsetsMutex);
+        qDeleteAll(m_loadedDocsets);
+        m_loadedDocsets.clear();
+    }
+
+    // Docsets released from now on are destroyed by the thread releasing them
+    QList<Docset *> releasedDocsets;
+    {
+        QMutexLocker locker(&m_releaseQueue->mutex);
+        m_releaseQueue->registry = nullptr;
+        releasedDocsets.swap(m_releaseQueue->docsets);
+    }
+    qDeleteAll(releasedDocsets);
 }
 
 void DocsetRegistry::init(const QString &path)
 {
-    for (const QString &name : m_docsets.keys())
+    // Drop docsets that are still loading from the previous path
+    {
+        QMutexLocker locker(&m_loadedDocsetsMutex);
+        m_loaderGeneration.fetchAndAddOrdered(1);
+        qDeleteAll(m_loadedDocsets);
+        m_loadedDocsets.clear();
+    }
+
+    for (const QString &name : names())
         remove(name);
 
     addDocsetsFromFolder(path);
 }
 
+DocsetRegistry::Snapshot DocsetRegistry::snapshot() const
+{
+    return std::atomic_load(&m_docsets);
+}
+
+/// Replaces the current snapshot, must be called with m_writeMutex locked.
+void DocsetRegistry::publish(const Snapshot &snapshot)
+{
+    std::atomic_store(&m_docsets, snapshot);
+}
+
 int DocsetRegistry::count() const
 {
-    return m_docsets.count();
+    return snapshot()->count();
 }
 
 bool DocsetRegistry::contains(const QString &name) const
 {
-    return m_docsets.contains(name);
+    return snapshot()->contains(name);
 }
 
 QStringList DocsetRegistry::names() const
 {
-    return m_docsets.keys();
+    return snapshot()->names();
 }
 
 QStringList DocsetRegistry::keywords() const
@@ -83,72 +193,168 @@ QStringList DocsetRegistry::keywords() const
 
 DocsetKeywords DocsetRegistry::docsetKeywords() const
 {
-    DocsetKeywords keywords;
+    QMutexLocker locker(&m_docsetKeywordsMutex);
+    if (m_isDocsetKeywordsValid)
+        return m_docsetKeywords;
+
+    // Keywords index the docsets of a single snapshot
+    const Snapshot docsets = snapshot();
+    DocsetKeywords keywords(docsets->docsets());
 
     // Add keywords for docsets.
-    for (const Docset * const docset: docsets())
+    for (const std::shared_ptr<Docset> &docset : *docsets)
         for (QString keyword: docset->keywords())
-            keywords.add(keyword, const_cast<Docset*>(docset));
+            keywords.add(keyword, docset.get());
 
     // Add user defined keywords for docsets.
     for (const QString docsetName: m_userDefinedKeywords.keys())
-        if (m_docsets.contains(docsetName)) {
+        if (docsets->contains(docsetName)) {
             QString keyword = m_userDefinedKeywords.value(docsetName);
-            keywords.add(keyword, docset(docsetName));
+            keywords.add(keyword, docsets->value(docsetName).get());
         }
 
     // Add keywords for docset groups.
     for (QString keyword: m_docsetGroups.keys())
         keywords.add(keyword, m_docsetGroups.value(keyword));
 
+    m_docsetKeywords = keywords;
+    m_isDocsetKeywordsValid = true;
     return keywords;
 }
 
+void DocsetRegistry::invalidateDocsetKeywords()
+{
+    QMutexLocker locker(&m_docsetKeywordsMutex);
+    m_isDocsetKeywordsValid = false;
+    m_docsetKeywords = DocsetKeywords();
+}
+
 void DocsetRegistry::setKeywordGroups(const QMap<QString, QStringList> docsetKeywordGroups)
 {
+    QMutexLocker locker(&m_docsetKeywordsMutex);
     m_docsetGroups = docsetKeywordGroups;
+    m_isDocsetKeywordsValid = false;
+    m_docsetKeywords = DocsetKeywords();
 }
 
 void DocsetRegistry::setUserDefinedKeywords(const QMap<QString, QString> docsetKeywords)
 {
+    QMutexLocker locker(&m_docsetKeywordsMutex);
     m_userDefinedKeywords = docsetKeywords;
+    m_isDocsetKeywordsValid = false;
+    m_docsetKeywords = DocsetKeywords();
+}
+
+void DocsetRegistry::setFuzzySearchEnabled(bool enabled)
+{
+    m_fuzzySearchEnabled = enabled;
+}
+
+void DocsetRegistry::setPrefetchEnabled(bool enabled)
+{
+    m_prefetchEnabled = enabled;
+    if (!enabled)
+        cancelPrefetch();
 }
 
 QString DocsetRegistry::userDefinedKeyword(const QString &docsetName) const
 {
-    QString userDefinedKeyword = m_userDefinedKeywords.value(docsetName);
+    QString userDefinedKeyword;
+    {
+        QMutexLocker locker(&m_docsetKeywordsMutex);
+        userDefinedKeyword = m_userDefinedKeywords.value(docsetName);
+    }
     if (userDefinedKeyword != nullptr)
         return userDefinedKeyword;
 
-    Docset *doc = docset(docsetName);
-    return doc != nullptr
+    const std::shared_ptr<Docset> doc = docset(docsetName);
+    return doc
         ? doc->keywords().first()
         : QString();
 }
 
+/**
+ * @brief DocsetRegistry::remove
+ * Removes a docset from the registry. It is destroyed once no snapshot,
+ * e.g. of a running search, refers to it anymore.
+ */
 void DocsetRegistry::remove(const QString &name)
 {
     emit docsetAboutToBeRemoved(name);
-    delete m_docsets.take(name);
+    {
+        QMutexLocker locker(&m_writeMutex);
+        std::shared_ptr<DocsetTable> docsets(new DocsetTable(*snapshot()));
+        docsets->remove(name);
+        publish(docsets);
+    }
+    invalidateDocsetKeywords();
     emit docsetRemoved(name);
 }
 
-Docset *DocsetRegistry::docset(const QString &name) const
+/**
+ * @brief DocsetRegistry::docset
+ * Returns docset \a name or null. The docset stays alive while the pointer
+ * is held, even if it is removed or replaced meanwhile.
+ */
+std::shared_ptr<Docset> DocsetRegistry::docset(const QString &name) const
+{
+    return snapshot()->value(name);
+}
+
+QList<std::shared_ptr<Docset>> DocsetRegistry::docsets() const
+{
+    return snapshot()->docsets();
+}
+
+/**
+ * @brief DocsetRegistry::openDocset
+ * Opens docset \a name on the search scheduler, so that the caller does not wait for its
+ * database. docsetOpened() is emitted once it is open, an unreadable docset is removed instead.
+ */
+void DocsetRegistry::openDocset(const QString &name)
 {
-    return m_docsets.value(name);
+    QMetaObject::invokeMethod(this, "_openDocset", Qt::QueuedConnection, Q_ARG(QString, name));
 }
 
-Docset *DocsetRegistry::docset(int index) const
+void DocsetRegistry::_openDocset(const QString &name)
 {
-    /// TODO: sort docsets
-    if (index < 0 || index >= m_docsets.size())
-        return nullptr;
-    return (m_docsets.cbegin() + index).value();
+    const std::shared_ptr<Docset> docset = snapshot()->value(name);
+    if (!docset)
+        return;
+
+    if (docset->isOpen()) {
+        if (!rejectUnreadableDocset(docset))
+            emit docsetOpened(name);
+        return;
+    }
+
+    QFutureWatcher<bool> *watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, docset]() {
+        watcher->deleteLater();
+        if (!rejectUnreadableDocset(docset))
+            emit docsetOpened(docset->name());
+    });
+    watcher->setFuture(SearchScheduler::instance()->run(SearchScheduler::Priority::Interactive,
+                                                        [docset]() {
+        return docset->open();
+    }));
 }
 
-QList<Docset *> DocsetRegistry::docsets() const
+/**
+ * @brief DocsetRegistry::rejectUnreadableDocset
+ * Removes \a docset if its database turned out to be unreadable when it was
+ * first opened. Returns true if the docset is unreadable.
+ */
+bool DocsetRegistry::rejectUnreadableDocset(const std::shared_ptr<Docset> &docset)
 {
-    return m_docsets.values();
+    if (docset->isValid())
+        return false;
+
+    /// TODO: Emit error
+    // A docset of the same name may have replaced it meanwhile
+    if (snapshot()->value(docset->name()) == docset)
+        remove(docset->name());
+    return true;
 }
 
 void DocsetRegistry::addDocset(const QString &path)
@@ -159,8 +365,47 @@ void DocsetRegistry::addDocset(const QString &path)
 
 void DocsetRegistry::_addDocset(const QString &path)
 {
-    Docset *docset = new Docset(path);
+    addLoadedDocset(new Docset(path));
+}
+
+/// Adds docsets handed over by loaders, emits docsetsLoaded() once all loaders finished.
+void DocsetRegistry::_addLoadedDocsets()
+{
+    QList<Docset *> docsets;
+    bool isLoadingFinished;
+    {
+        QMutexLocker locker(&m_loadedDocsetsMutex);
+        docsets.swap(m_loadedDocsets);
+        isLoadingFinished = m_runningLoaderCount == 0;
+    }
+
+    for (Docset *docset : docsets)
+        addLoadedDocset(docset);
+
+    if (isLoadingFinished && !docsets.isEmpty())
+        emit docsetsLoaded();
+}
+
+/// Called by a loader from the loader pool.
+void DocsetRegistry::handOverLoadedDocset(Docset *docset, int generation)
+{
+    QMutexLocker locker(&m_loadedDocsetsMutex);
+    --m_runningLoaderCount;
 
+    // init() may have been called for a different path meanwhile
+    if (generation != m_loaderGeneration.load()) {
+        delete docset;
+        return;
+    }
+
+    // A single call adds all docsets handed over until it runs
+    if (m_loadedDocsets.isEmpty())
+        QMetaObject::invokeMethod(this, "_addLoadedDocsets", Qt::QueuedConnection);
+    m_loadedDocsets.append(docset);
+}
+
+void DocsetRegistry::addLoadedDocset(Docset *docset)
+{
     /// TODO: Emit error
     if (!docset->isValid()) {
         delete docset;
@@ -169,59 +414,337 @@ void DocsetRegistry::_addDocset(const QString &path)
 
     const QString name = docset->name();
 
-    if (m_docsets.contains(name))
+    if (contains(name))
         remove(name);
 
-    m_docsets[name] = docset;
+    {
+        QMutexLocker locker(&m_writeMutex);
+        std::shared_ptr<DocsetTable> docsets(new DocsetTable(*snapshot()));
+        const std::shared_ptr<ReleaseQueue> queue = m_releaseQueue;
+        docsets->insert(std::shared_ptr<Docset>(docset, [queue](Docset *docset) {
+            releaseDocset(queue, docset);
+        }));
+        publish(docsets);
+    }
+    invalidateDocsetKeywords();
     emit docsetAdded(name);
 }
 
+/**
+ * @brief DocsetRegistry::releaseDocset
+ * Deleter of shared docsets. The last reference is often dropped by a search
+ * task or by the GUI, the docset is destroyed on the registry thread then, so
+ * that neither is blocked by its cleanup.
+ */
+void DocsetRegistry::releaseDocset(const std::shared_ptr<ReleaseQueue> &queue, Docset *docset)
+{
+    {
+        QMutexLocker locker(&queue->mutex);
+        DocsetRegistry *registry = queue->registry;
+        if (registry && QThread::currentThread() != registry->m_thread.get()) {
+            // A single call destroys all docsets released until it runs
+            if (queue->docsets.isEmpty())
+                QMetaObject::invokeMethod(registry, "_deleteReleasedDocsets", Qt::QueuedConnection);
+            queue->docsets.append(docset);
+            return;
+        }
+    }
+
+    delete docset;
+}
+
+void DocsetRegistry::_deleteReleasedDocsets()
+{
+    QList<Docset *> docsets;
+    {
+        QMutexLocker locker(&m_releaseQueue->mutex);
+        docsets.swap(m_releaseQueue->docsets);
+    }
+
+    qDeleteAll(docsets);
+}
+
+/**
+ * @brief DocsetRegistry::search
+ * Schedules a search for \a query. A query that has not been dispatched yet
+ * is replaced, so cancelled queries never queue up on the registry thread.
+ */
 void DocsetRegistry::search(const QString &query, CancellationToken token)
 {
-    qRegisterMetaType<CancellationToken>("CancellationToken");
-    qRegisterMetaType<CancellationToken>("Zeal::CancellationToken");
-    QMetaObject::invokeMethod(this, "_runQueryAsync", Qt::QueuedConnection,
-                              Q_ARG(QString, query), Q_ARG(CancellationToken, token));
+    {
+        QMutexLocker locker(&m_pendingQueryMutex);
+        m_pendingQuery = query;
+        m_pendingQueryToken = token;
+        m_hasPendingQuery = true;
+
+        if (!m_isDispatchQueued) {
+            m_isDispatchQueued = true;
+            QMetaObject::invokeMethod(this, "_dispatchQuery", Qt::QueuedConnection);
+        }
+    }
+
+    // Real input always wins over speculative searches. The query is published first,
+    // so prefetch() either sees it and does not start, or its searches are cancelled here.
+    cancelPrefetch();
+}
+
+/**
+ * @brief DocsetRegistry::_dispatchQuery
+ * Runs the pending query right away if the previous searches were fast or have
+ * finished. Otherwise keystrokes are coalesced until running searches finish,
+ * but no longer than the last search took or MaxDispatchDelay.
+ */
+void DocsetRegistry::_dispatchQuery()
+{
+    {
+        QMutexLocker locker(&m_pendingQueryMutex);
+        m_isDispatchQueued = false;
+    }
+
+    if (m_dispatchTimer->isActive())
+        return;
+
+    if (m_runningSearchCount > 0 && m_searchDuration > FastSearchDuration) {
+        m_dispatchTimer->start(static_cast<int>(qMin(m_searchDuration, MaxDispatchDelay)));
+        return;
+    }
+
+    _runPendingQuery();
 }
 
-void MergeQueryResults(QList<SearchResult> &finalResult, const QList<SearchResult> &partial)
+void DocsetRegistry::_runPendingQuery()
 {
-    finalResult += partial;
+    m_dispatchTimer->stop();
+
+    QString query;
+    CancellationToken token;
+    {
+        QMutexLocker locker(&m_pendingQueryMutex);
+        if (!m_hasPendingQuery)
+            return;
+
+        query = m_pendingQuery;
+        token = m_pendingQueryToken;
+        m_hasPendingQuery = false;
+    }
+
+    if (!token.isCancelled())
+        _runQueryAsync(query, token);
 }
 
 SearchQuery DocsetRegistry::getSearchQuery(const QString &queryStr) const
 {
-    return SearchQuery::fromString(queryStr, docsetKeywords());
+    SearchStatistics::Timer timer(SearchStatistics::Stage::Parse);
+    SearchQuery searchQuery = SearchQuery::fromString(queryStr, docsetKeywords());
+    searchQuery.setFuzzy(m_fuzzySearchEnabled);
+    return searchQuery;
 }
 
 void DocsetRegistry::_runQueryAsync(const QString &query, const CancellationToken token)
 {
-    SearchQuery searchQuery = getSearchQuery(query);
-    QFuture<QList<SearchResult>> queryResultsFuture = QtConcurrent::mappedReduced(
-                docsets(),
-                std::bind(&Docset::search, std::placeholders::_1, searchQuery, token),
-                &MergeQueryResults);
-    QList<SearchResult> queryResults = queryResultsFuture.result();
-    std::sort(queryResults.begin(), queryResults.end());
+    const SearchQuery searchQuery = getSearchQuery(query);
+
+    // Docsets of the snapshot stay alive until their searches finish, even if removed meanwhile.
+    // Keywords index the snapshot they were built from, so a filter only needs its set bits.
+    QList<std::shared_ptr<Docset>> enabledDocsets;
+    if (searchQuery.hasDocsetFilter()) {
+        const DocsetKeywords keywords = searchQuery.docsetKeywords();
+        const QBitArray enabled = searchQuery.enabledDocsets();
+        for (int i = 0; i < enabled.size(); ++i) {
+            if (enabled.testBit(i))
+                enabledDocsets.append(keywords.docset(i));
+        }
+    } else {
+        enabledDocsets = snapshot()->docsets();
+    }
+
+    std::shared_ptr<QueryState> state(new QueryState());
+    state->token = token;
+    state->searchQuery = searchQuery;
+    state->docsets = enabledDocsets;
+    state->pendingCount = enabledDocsets.size();
+    state->timer.start();
 
-    if (!token.isCancelled()) {
-        m_queryResults = queryResults;
+    if (enabledDocsets.isEmpty()) {
+        m_queryResults.clear();
+        emit queryResultsAvailable(QList<SearchResult>(), true);
         emit queryCompleted();
+        return;
+    }
+
+    // Every docset is searched as a separate task, results are published as they arrive
+    for (const std::shared_ptr<Docset> &docset : enabledDocsets) {
+        QFutureWatcher<QList<SearchResult>> *watcher = new QFutureWatcher<QList<SearchResult>>(this);
+        connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, state, docset]() {
+            const QList<SearchResult> results = watcher->result();
+            watcher->deleteLater();
+
+            // The first search opens the docset, an unreadable one is removed then
+            rejectUnreadableDocset(docset);
+
+            // A query waiting for running searches is dispatched once they finish
+            if (--m_runningSearchCount == 0 && m_dispatchTimer->isActive())
+                QMetaObject::invokeMethod(this, "_runPendingQuery", Qt::QueuedConnection);
+
+            const bool isCancelled = state->token.isCancelled();
+            if (!isCancelled) {
+                // Both lists are sorted, so merging the best MaxResults is linear
+                {
+                    SearchStatistics::Timer timer(SearchStatistics::Stage::Merge);
+                    QList<SearchResult> mergedResults;
+                    mergedResults.reserve(state->results.size() + results.size());
+                    std::merge(state->results.cbegin(), state->results.cend(),
+                               results.cbegin(), results.cend(), std::back_inserter(mergedResults));
+                    if (mergedResults.size() > MaxResults)
+                        mergedResults.erase(mergedResults.begin() + MaxResults, mergedResults.end());
+                    state->results.swap(mergedResults);
+                }
+
+                emit queryResultsAvailable(results, state->isFirstBatch);
+                state->isFirstBatch = false;
+            }
+
+            if (--state->pendingCount > 0)
+                return;
+
+            // Superseded queries count as well, so that one slow query does not delay the next ones for good
+            const qint64 elapsed = state->timer.nsecsElapsed();
+            m_searchDuration = (m_searchDuration + elapsed / 1000000) / 2;
+
+            if (isCancelled) {
+                SearchStatistics::instance()->record(SearchStatistics::Stage::CancelledQuery, elapsed);
+                return;
+            }
+
+            SearchStatistics::instance()->record(SearchStatistics::Stage::Query, elapsed);
+            m_queryResults = state->results;
+            emit queryCompleted();
+
+            if (m_prefetchEnabled)
+                prefetch(state->searchQuery, state->docsets, state->results);
+        });
+
+        ++m_runningSearchCount;
+        watcher->setFuture(SearchScheduler::instance()->run(SearchScheduler::Priority::Interactive,
+                                                            [docset, searchQuery, token]() {
+            SearchStatistics::Timer timer(SearchStatistics::Stage::Docset, docset->name());
+            SearchResultHeap heap(MaxResults);
+            for (const SearchResult &result : docset->search(searchQuery, token))
+                heap.push(result);
+            return heap.takeSorted();
+        }));
     }
 }
 
+/**
+ * @brief DocsetRegistry::prefetch
+ * Searches the most likely continuations of \a searchQuery at low priority,
+ * so that matches of the next keystroke are already in the prefix cache.
+ *
+ * Likely next characters are the ones following the query in names of the
+ * best \a results.
+ */
+void DocsetRegistry::prefetch(const SearchQuery &searchQuery,
+                              const QList<std::shared_ptr<Docset>> &docsets,
+                              const QList<SearchResult> &results)
+{
+    const QString foldedQuery = searchQuery.foldedQuery();
+    if (foldedQuery.isEmpty())
+        return;
+
+    QHash<QChar, int> characterCounts;
+    for (const SearchResult &result : results) {
+        const QString name = SymbolIndex::foldCase(result.nameRef());
+        const int next = name.indexOf(foldedQuery) + foldedQuery.size();
+        if (next >= foldedQuery.size() && next < name.size())
+            ++characterCounts[name.at(next)];
+    }
+
+    QList<QPair<int, QChar>> characters;
+    for (auto it = characterCounts.cbegin(); it != characterCounts.cend(); ++it)
+        characters.append(qMakePair(it.value(), it.key()));
+    std::sort(characters.begin(), characters.end(),
+              [](const QPair<int, QChar> &a, const QPair<int, QChar> &b) {
+        return a.first > b.first;
+    });
+
+    QMutexLocker locker(&m_prefetchMutex);
+
+    // Do not start if a newer query is already waiting
+    {
+        QMutexLocker pendingLocker(&m_pendingQueryMutex);
+        if (m_hasPendingQuery)
+            return;
+    }
+
+    m_prefetchToken.cancel();
+    m_prefetchToken = CancellationToken();
+
+    for (auto it = m_prefetchFutures.begin(); it != m_prefetchFutures.end();) {
+        if (it->isFinished())
+            it = m_prefetchFutures.erase(it);
+        else
+            ++it;
+    }
+
+    const CancellationToken token = m_prefetchToken;
+    for (int i = 0; i < qMin(PrefetchCharacterCount, characters.size()); ++i) {
+        SearchQuery nextQuery = searchQuery;
+        nextQuery.setQuery(searchQuery.query() + characters.at(i).second);
+
+        for (const std::shared_ptr<Docset> &docset : docsets) {
+            m_prefetchFutures.append(SearchScheduler::instance()->run(
+                                         SearchScheduler::Priority::Prefetch,
+                                         [docset, nextQuery, token]() {
+                docset->search(nextQuery, token);
+            }));
+        }
+    }
+}
+
+/// Cancels speculative searches without waiting for the running ones.
+void DocsetRegistry::cancelPrefetch()
+{
+    QMutexLocker locker(&m_prefetchMutex);
+    m_prefetchToken.cancel();
+}
+
+/// Cancels speculative searches and waits until none of them runs.
+void DocsetRegistry::waitForPrefetch()
+{
+    QMutexLocker locker(&m_prefetchMutex);
+    m_prefetchToken.cancel();
+    for (QFuture<void> &future : m_prefetchFutures)
+        future.waitForFinished();
+    m_prefetchFutures.clear();
+}
+
 const QList<SearchResult> &DocsetRegistry::queryResults()
 {
     return m_queryResults;
 }
 
-// Recursively finds and adds all docsets in a given directory.
+// Loads a docset on the loader pool, it is added to the registry once ready.
+void DocsetRegistry::loadDocset(const QString &path)
+{
+    {
+        QMutexLocker locker(&m_loadedDocsetsMutex);
+        ++m_runningLoaderCount;
+    }
+
+    m_loaderPool.start(new DocsetLoader(path, m_loaderGeneration.load(),
+                                        [this](Docset *docset, int generation) {
+        handOverLoadedDocset(docset, generation);
+    }));
+}
+
+// Recursively finds and loads all docsets in a given directory.
 void DocsetRegistry::addDocsetsFromFolder(const QString &path)
 {
     const QDir dir(path);
     for (const QFileInfo &subdir : dir.entryInfoList(QDir::NoDotAndDotDot | QDir::AllDirs)) {
         if (subdir.suffix() == QLatin1String("docset"))
-            addDocset(subdir.absoluteFilePath());
+            loadDocset(subdir.absoluteFilePath());
         else
             addDocsetsFromFolder(subdir.absoluteFilePath());
     }
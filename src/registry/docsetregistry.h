@@ -26,16 +26,20 @@
 
 #include "cancellationtoken.h"
 #include "docset.h"
+#include "docsetkeywords.h"
+#include "docsettable.h"
 #include "searchresult.h"
 
 #include <memory>
 #include <QMap>
+#include <QMutex>
+#include <QThreadPool>
 
 class QThread;
+class QTimer;
 
 namespace Zeal {
 
-class DocsetKeywords;
 class SearchQuery;
 
 /**
@@ -49,25 +53,33 @@ public:
     explicit DocsetRegistry(QObject *parent = nullptr);
     ~DocsetRegistry() override;
 
+    /// Docsets sorted by name. A snapshot is never modified, so it can be read from any thread.
+    typedef std::shared_ptr<const DocsetTable> Snapshot;
+
     void init(const QString &path);
 
+    /// Returns the current docsets, which stay alive as long as the snapshot is held.
+    Snapshot snapshot() const;
+
     int count() const;
     bool contains(const QString &name) const;
     QStringList names() const;
     void remove(const QString &name);
+    void openDocset(const QString &name);
 
-    Docset *docset(const QString &name) const;
-    Docset *docset(int index) const;
+    std::shared_ptr<Docset> docset(const QString &name) const;
 
     void search(const QString &query, CancellationToken token);
     const QList<SearchResult> &queryResults();
-    QList<Docset *> docsets() const;
+    QList<std::shared_ptr<Docset>> docsets() const;
     SearchQuery getSearchQuery(const QString &queryStr) const;
 
     QStringList keywords() const;
     void setKeywordGroups(const QMap<QString, QStringList> docsetKeywordGroups);
     void setUserDefinedKeywords(const QMap<QString, QString> docsetKeywords);
     QString userDefinedKeyword(const QString &docsetName) const;
+    void setFuzzySearchEnabled(bool enabled);
+    void setPrefetchEnabled(bool enabled);
 
     /// The number of results that should be retuned by the search.
     static const int MaxResults = 100;
@@ -77,24 +89,86 @@ public slots:
 
 signals:
     void docsetAdded(const QString &name);
+    /// Emitted after docsets found by init() have been added.
+    void docsetsLoaded();
     void docsetAboutToBeRemoved(const QString &name);
     void docsetRemoved(const QString &name);
+    /// Emitted once a docset has been opened by openDocset().
+    void docsetOpened(const QString &name);
     void keywordGroupsChanged();
+    /// Emitted with sorted results of each docset as soon as it is searched.
+    /// The first batch of a query replaces results of the previous query.
+    void queryResultsAvailable(const QList<SearchResult> &results, bool isFirstBatch);
     void queryCompleted();
 
 private slots:
     void _addDocset(const QString &path);
+    void _addLoadedDocsets();
+    void _deleteReleasedDocsets();
+    void _openDocset(const QString &name);
+    void _dispatchQuery();
+    void _runPendingQuery();
     void _runQueryAsync(const QString &query, const CancellationToken token);
 
 private:
+    struct ReleaseQueue;
+
     void addDocsetsFromFolder(const QString &path);
+    void loadDocset(const QString &path);
+    void handOverLoadedDocset(Docset *docset, int generation);
+    void addLoadedDocset(Docset *docset);
+    static void releaseDocset(const std::shared_ptr<ReleaseQueue> &queue, Docset *docset);
+    bool rejectUnreadableDocset(const std::shared_ptr<Docset> &docset);
     DocsetKeywords docsetKeywords() const;
+    void invalidateDocsetKeywords();
+    void prefetch(const SearchQuery &searchQuery, const QList<std::shared_ptr<Docset>> &docsets,
+                  const QList<SearchResult> &results);
+    void cancelPrefetch();
+    void waitForPrefetch();
+
+    void publish(const Snapshot &snapshot);
 
     std::unique_ptr<QThread> m_thread;
-    QMap<QString, Docset *> m_docsets;
+    // Docsets found by init() are loaded in parallel on this pool.
+    QThreadPool m_loaderPool;
+    QAtomicInt m_loaderGeneration;
+    // Docsets loaded but not added yet, the generation is changed with the mutex locked
+    QMutex m_loadedDocsetsMutex;
+    QList<Docset *> m_loadedDocsets;
+    int m_runningLoaderCount = 0;
+    // Docsets released on other threads, shared with deleters that may outlive the registry
+    std::shared_ptr<ReleaseQueue> m_releaseQueue;
+    // Read with std::atomic_load(), replaced with std::atomic_store() under m_writeMutex
+    Snapshot m_docsets;
+    QMutex m_writeMutex;
+    // Keyword maps and the keywords built from them are guarded by m_docsetKeywordsMutex
+    mutable QMutex m_docsetKeywordsMutex;
     QMap<QString, QStringList> m_docsetGroups;
     QMap<QString, QString> m_userDefinedKeywords;
+    // Built on first use after docsets or keywords change
+    mutable DocsetKeywords m_docsetKeywords;
+    mutable bool m_isDocsetKeywordsValid = false;
+    bool m_fuzzySearchEnabled = false;
+    bool m_prefetchEnabled = false;
     QList<SearchResult> m_queryResults;
+
+    // Only the newest query passed to search() is kept until it is dispatched
+    QMutex m_pendingQueryMutex;
+    QString m_pendingQuery;
+    CancellationToken m_pendingQueryToken;
+    bool m_hasPendingQuery = false;
+    bool m_isDispatchQueued = false;
+
+    // Delays dispatch of queries while slow searches are still running
+    QTimer *m_dispatchTimer;
+    int m_runningSearchCount = 0;
+    // Running average of durations of all finished queries, in milliseconds
+    qint64 m_searchDuration = 0;
+
+    // Speculative searches warming the prefix cache, cancelled by any new query
+    QMutex m_prefetchMutex;
+    CancellationToken m_prefetchToken;
+    QList<QFuture<void>> m_prefetchFutures;
 };
 
 } // namespace Zeal
@@ -23,4 +23,72 @@
 
 #include "docsetsearchstrategy.h"
 
+#include "docset.h"
+#include "searchresult.h"
+#include "searchscheduler.h"
+
+#include <vector>
+
 using namespace Zeal;
+
+namespace {
+// Smallest number of items worth searching on a separate thread
+const int MinShardSize = 64 * 1024;
+}
+
+DocsetSearchStrategy::~DocsetSearchStrategy()
+{
+}
+
+bool DocsetSearchStrategy::searchSymbols(const SearchQuery &searchQuery, const QVector<int> *candidates,
+                                         CancellationToken token, QList<SearchResult> &results,
+                                         QVector<int> &matches)
+{
+    Q_UNUSED(searchQuery)
+    Q_UNUSED(candidates)
+    Q_UNUSED(token)
+    Q_UNUSED(results)
+    Q_UNUSED(matches)
+    return false;
+}
+
+void DocsetSearchStrategy::searchShards(int count, const ShardFunction &searchShard,
+                                        QList<SearchResult> &results, QVector<int> &matches)
+{
+    SearchScheduler *scheduler = SearchScheduler::instance();
+    const int shardCount = qBound(1, count / MinShardSize, scheduler->workerCount());
+    if (shardCount == 1) {
+        SearchResultHeap heap(Docset::MaxDocsetResultsCount);
+        searchShard(0, count, heap, matches);
+        results = heap.takeSorted();
+        return;
+    }
+
+    const auto shardFirst = [count, shardCount](int shard) {
+        return static_cast<int>(static_cast<qint64>(count) * shard / shardCount);
+    };
+
+    std::vector<SearchResultHeap> heaps(shardCount, SearchResultHeap(Docset::MaxDocsetResultsCount));
+    std::vector<QVector<int>> shardMatches(shardCount);
+
+    QVector<std::function<void()>> shards;
+    for (int i = 0; i < shardCount; ++i) {
+        shards.append([&, i]() {
+            searchShard(shardFirst(i), shardFirst(i + 1), heaps[i], shardMatches[i]);
+        });
+    }
+    scheduler->runAll(shards);
+
+    SearchResultHeap heap(Docset::MaxDocsetResultsCount);
+    int matchCount = 0;
+    for (int i = 0; i < shardCount; ++i) {
+        for (const SearchResult &result : heaps[i].takeSorted())
+            heap.push(result);
+        matchCount += shardMatches[i].size();
+    }
+
+    matches.reserve(matches.size() + matchCount);
+    for (const QVector<int> &ids : shardMatches)
+        matches += ids;
+    results = heap.takeSorted();
+}
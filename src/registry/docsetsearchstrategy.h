@@ -26,12 +26,15 @@
 
 #include "cancellationtoken.h"
 
+#include <functional>
 #include <QList>
+#include <QVector>
 
 namespace Zeal {
 
 class SearchQuery;
 struct SearchResult;
+class SearchResultHeap;
 
 /**
  * @brief The DocsetSearchStrategy class
@@ -40,11 +43,38 @@ struct SearchResult;
 class DocsetSearchStrategy
 {
 public:
+    virtual ~DocsetSearchStrategy();
+
     virtual QList<SearchResult> search(const SearchQuery &searchQuery, CancellationToken token) = 0;
 
-    /// Used to filter out cached results.
-    virtual bool validResult(const SearchQuery &searchQuery, SearchResult previousResult,
-                             SearchResult &result) = 0;
+    /**
+     * @brief searchSymbols
+     * Searches symbols of the docset symbol index. If \a candidates is not null,
+     * only these sorted symbol ids are searched.
+     *
+     * Sorted ids of all symbols that may match \a searchQuery are stored in
+     * \a matches, even if \a results are truncated.
+     *
+     * Returns false if the strategy does not search by symbol ids, or the index
+     * is not available yet.
+     */
+    virtual bool searchSymbols(const SearchQuery &searchQuery, const QVector<int> *candidates,
+                               CancellationToken token, QList<SearchResult> &results,
+                               QVector<int> &matches);
+
+protected:
+    /// Searches items in range [first, last), keeping results in the heap and sorted matching ids.
+    typedef std::function<void(int first, int last, SearchResultHeap &heap,
+                               QVector<int> &matches)> ShardFunction;
+
+    /**
+     * @brief searchShards
+     * Splits \a count items into contiguous shards, searches them in parallel
+     * on the SearchScheduler with \a searchShard and merges shard results by score. Matches of all
+     * shards are concatenated in shard order, so they stay sorted.
+     */
+    static void searchShards(int count, const ShardFunction &searchShard,
+                             QList<SearchResult> &results, QVector<int> &matches);
 };
 
 }
@@ -0,0 +1,111 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 Oleg Shparber
+** Copyright (C) 2013-2014 Jerzy Kozera
+** Contact: http://zealdocs.org/contact.html
+**
+** This file is part of Zeal.
+**
+** Zeal is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** Zeal is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Zeal. If not, see <http://www.gnu.org/licenses/>.
+**
+****************************************************************************/
+
+#include "docsettable.h"
+
+#include "docset.h"
+
+#include <algorithm>
+
+using namespace Zeal;
+
+int DocsetTable::count() const
+{
+    return m_docsets.size();
+}
+
+bool DocsetTable::isEmpty() const
+{
+    return m_docsets.isEmpty();
+}
+
+std::shared_ptr<Docset> DocsetTable::at(int row) const
+{
+    if (row < 0 || row >= m_docsets.size())
+        return std::shared_ptr<Docset>();
+    return m_docsets.at(row);
+}
+
+std::shared_ptr<Docset> DocsetTable::value(const QString &name) const
+{
+    return at(indexOf(name));
+}
+
+bool DocsetTable::contains(const QString &name) const
+{
+    return indexOf(name) != -1;
+}
+
+int DocsetTable::indexOf(const QString &name) const
+{
+    const int row = lowerBound(name);
+    return row < m_names.size() && m_names.at(row) == name ? row : -1;
+}
+
+int DocsetTable::lowerBound(const QString &name) const
+{
+    return std::lower_bound(m_names.cbegin(), m_names.cend(), name) - m_names.cbegin();
+}
+
+QStringList DocsetTable::names() const
+{
+    return m_names;
+}
+
+QList<std::shared_ptr<Docset>> DocsetTable::docsets() const
+{
+    return m_docsets.toList();
+}
+
+void DocsetTable::insert(const std::shared_ptr<Docset> &docset)
+{
+    const QString name = docset->name();
+    const int row = lowerBound(name);
+    if (row < m_names.size() && m_names.at(row) == name) {
+        m_docsets[row] = docset;
+        return;
+    }
+
+    m_names.insert(row, name);
+    m_docsets.insert(row, docset);
+}
+
+void DocsetTable::remove(const QString &name)
+{
+    const int row = indexOf(name);
+    if (row == -1)
+        return;
+
+    m_names.removeAt(row);
+    m_docsets.remove(row);
+}
+
+DocsetTable::const_iterator DocsetTable::begin() const
+{
+    return m_docsets.cbegin();
+}
+
+DocsetTable::const_iterator DocsetTable::end() const
+{
+    return m_docsets.cend();
+}
@@ -0,0 +1,73 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 Oleg Shparber
+** Copyright (C) 2013-2014 Jerzy Kozera
+** Contact: http://zealdocs.org/contact.html
+**
+** This file is part of Zeal.
+**
+** Zeal is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** Zeal is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Zeal. If not, see <http://www.gnu.org/licenses/>.
+**
+****************************************************************************/
+
+#ifndef DOCSETTABLE_H
+#define DOCSETTABLE_H
+
+#include <memory>
+#include <QStringList>
+#include <QVector>
+
+namespace Zeal {
+
+class Docset;
+
+/**
+ * @brief The DocsetTable class
+ * Docsets sorted by name. Docsets are accessed by row in constant time and
+ * by name with a binary search.
+ */
+class DocsetTable
+{
+public:
+    typedef QVector<std::shared_ptr<Docset>>::const_iterator const_iterator;
+
+    int count() const;
+    bool isEmpty() const;
+
+    std::shared_ptr<Docset> at(int row) const;
+    std::shared_ptr<Docset> value(const QString &name) const;
+    bool contains(const QString &name) const;
+    /// Returns the row of docset \a name, or -1 if there is none.
+    int indexOf(const QString &name) const;
+    /// Returns the row at which docset \a name is or would be inserted.
+    int lowerBound(const QString &name) const;
+
+    QStringList names() const;
+    QList<std::shared_ptr<Docset>> docsets() const;
+
+    /// Inserts \a docset in order, replacing a docset with the same name.
+    void insert(const std::shared_ptr<Docset> &docset);
+    void remove(const QString &name);
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+private:
+    QStringList m_names;
+    QVector<std::shared_ptr<Docset>> m_docsets;
+};
+
+} // namespace Zeal
+
+#endif // DOCSETTABLE_H
@@ -0,0 +1,188 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 Oleg Shparber
+** Copyright (C) 2013-2014 Jerzy Kozera
+** Contact: http://zealdocs.org/contact.html
+**
+** This file is part of Zeal.
+**
+** Zeal is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** Zeal is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Zeal. If not, see <http://www.gnu.org/licenses/>.
+**
+****************************************************************************/
+
+#include "fuzzysearchstrategy.h"
+
+#include "docset.h"
+#include "searchquery.h"
+#include "searchresult.h"
+#include "searchstatistics.h"
+#include "symbolindex.h"
+
+#include <algorithm>
+
+using namespace Zeal;
+
+namespace {
+const int MatchScore = 16;
+const int BoundaryBonus = 8;
+const int CamelCaseBonus = 6;
+const int ConsecutiveBonus = 5;
+const int StartBonus = 8;
+const int GapPenalty = 3;
+
+// How often the search polls the cancellation token.
+const int CancellationCheckInterval = 1024;
+
+inline bool isSeparator(QChar ch)
+{
+    return ch == QLatin1Char('.') || ch == QLatin1Char(':') || ch == QLatin1Char('/')
+            || ch == QLatin1Char('_') || ch == QLatin1Char('-') || ch == QLatin1Char(' ');
+}
+
+int boundaryBonus(const QChar *name, int pos)
+{
+    if (pos == 0)
+        return BoundaryBonus + StartBonus;
+
+    const QChar prev = name[pos - 1];
+    const QChar ch = name[pos];
+    if (isSeparator(prev))
+        return BoundaryBonus;
+    if ((ch.isUpper() && !prev.isUpper()) || (ch.isDigit() && !prev.isDigit()))
+        return CamelCaseBonus;
+    return 0;
+}
+}
+
+FuzzySearchStrategy::FuzzySearchStrategy(Docset *docset,
+                                         std::unique_ptr<DocsetSearchStrategy> fallback)
+    : m_docset(docset),
+      m_fallback(std::move(fallback))
+{
+}
+
+QList<SearchResult> FuzzySearchStrategy::search(const SearchQuery &searchQuery, CancellationToken token)
+{
+    QList<SearchResult> results;
+    QVector<int> matches;
+    if (!searchSymbols(searchQuery, nullptr, token, results, matches))
+        return m_fallback->search(searchQuery, token);
+    return results;
+}
+
+bool FuzzySearchStrategy::searchSymbols(const SearchQuery &searchQuery, const QVector<int> *candidates,
+                                        CancellationToken token, QList<SearchResult> &results,
+                                        QVector<int> &matches)
+{
+    const SymbolIndex *index = m_docset->symbolIndex();
+    if (!index)
+        return false;
+
+    const std::shared_ptr<const Docset> docset = m_docset->shared_from_this();
+    const QString foldedQuery = searchQuery.foldedQuery();
+    const quint64 queryMask = SymbolIndex::charMask(foldedQuery);
+
+    const auto searchShard = [&](int first, int last, SearchResultHeap &heap, QVector<int> &shardMatches) {
+        // Matching and scoring are a single pass
+        SearchStatistics::Timer timer(SearchStatistics::Stage::Scoring);
+        for (int i = first; i < last; ++i) {
+            if ((i - first) % CancellationCheckInterval == 0 && token.isCancelled())
+                break;
+
+            const int id = candidates ? candidates->at(i) : i;
+            const int nameLength = index->nameLength(id);
+            if ((index->charMask(id) & queryMask) != queryMask || nameLength < foldedQuery.size())
+                continue;
+
+            // Skip matching if even a perfect match would not be kept,
+            // but keep the symbol as a candidate for longer queries
+            if (maxScore(nameLength, foldedQuery.size()) < heap.worstScore()) {
+                shardMatches.append(id);
+                continue;
+            }
+
+            const int score = FuzzySearchStrategy::score(index->nameData(id), index->foldedNameData(id),
+                                                         nameLength, foldedQuery);
+            if (score < 0)
+                continue;
+
+            shardMatches.append(id);
+
+            SearchResult result = SearchResult::fromIndex(docset, index, id, score);
+            result.updateSortKey(searchQuery.query());
+            heap.push(result);
+        }
+    };
+
+    searchShards(candidates ? candidates->size() : index->symbolCount(), searchShard, results, matches);
+    return true;
+}
+
+/**
+ * @brief FuzzySearchStrategy::score
+ * Finds the shortest window of \a foldedName ending at the first complete match,
+ * then scores the leftmost match inside of it.
+ */
+int FuzzySearchStrategy::score(const QChar *name, const QChar *foldedName, int nameLength,
+                               const QString &foldedQuery)
+{
+    const QChar *query = foldedQuery.constData();
+    const int queryLength = foldedQuery.size();
+    if (queryLength == 0)
+        return maxScore(nameLength, 0);
+
+    // Forward pass finds where the first match ends
+    int end = -1;
+    for (int i = 0, j = 0; i < nameLength; ++i) {
+        if (foldedName[i] == query[j] && ++j == queryLength) {
+            end = i;
+            break;
+        }
+    }
+    if (end == -1)
+        return -1;
+
+    // Backward pass finds the latest start of a match ending there
+    int start = end;
+    for (int j = queryLength - 1; j >= 0; --start) {
+        if (foldedName[start] == query[j])
+            --j;
+    }
+    ++start;
+
+    int score = -(nameLength - queryLength);
+    int prev = -2;
+    for (int i = start, j = 0; j < queryLength; ++i) {
+        if (foldedName[i] != query[j])
+            continue;
+
+        int bonus = boundaryBonus(name, i);
+        if (i == prev + 1)
+            bonus = std::max(bonus, ConsecutiveBonus);
+        else if (j > 0)
+            score -= GapPenalty;
+
+        score += MatchScore + bonus;
+        prev = i;
+        ++j;
+    }
+
+    return std::max(1, score);
+}
+
+int FuzzySearchStrategy::maxScore(int nameLength, int queryLength)
+{
+    return std::max(1, queryLength * (MatchScore + BoundaryBonus) + StartBonus
+                    - (nameLength - queryLength));
+}
@@ -0,0 +1,72 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 Oleg Shparber
+** Copyright (C) 2013-2014 Jerzy Kozera
+** Contact: http://zealdocs.org/contact.html
+**
+** This file is part of Zeal.
+**
+** Zeal is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** Zeal is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Zeal. If not, see <http://www.gnu.org/licenses/>.
+**
+****************************************************************************/
+
+#ifndef FUZZYSEARCHSTRATEGY_H
+#define FUZZYSEARCHSTRATEGY_H
+
+#include "cancellationtoken.h"
+#include "docsetsearchstrategy.h"
+
+#include <memory>
+
+class QChar;
+
+namespace Zeal {
+
+class Docset;
+
+/**
+ * @brief The FuzzySearchStrategy class
+ * A search strategy that finds symbols containing all query characters in order,
+ * so that e.g. "qstrlst" finds "QStringList".
+ *
+ * Matches on camel case humps and after separators score higher, gaps and
+ * unmatched characters score lower. Symbols are rejected early by character
+ * bitmasks from the SymbolIndex, and without matching if even a perfect match
+ * could not beat the results kept so far.
+ *
+ * If the index is not available, the search is delegated to the fallback strategy.
+ */
+class FuzzySearchStrategy : public DocsetSearchStrategy
+{
+public:
+    FuzzySearchStrategy(Docset *docset, std::unique_ptr<DocsetSearchStrategy> fallback);
+    QList<SearchResult> search(const SearchQuery &searchQuery, CancellationToken token) override;
+    bool searchSymbols(const SearchQuery &searchQuery, const QVector<int> *candidates,
+                       CancellationToken token, QList<SearchResult> &results,
+                       QVector<int> &matches) override;
+
+    /// Returns score of \a query in \a name, or -1 if it is not a subsequence of \a name.
+    static int score(const QChar *name, const QChar *foldedName, int nameLength,
+                     const QString &foldedQuery);
+    /// Returns the highest score() possible for a name of \a nameLength.
+    static int maxScore(int nameLength, int queryLength);
+
+private:
+    Docset *m_docset;
+    std::unique_ptr<DocsetSearchStrategy> m_fallback;
+};
+
+}
+
+#endif // FUZZYSEARCHSTRATEGY_H
@@ -0,0 +1,80 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 Oleg Shparber
+** Copyright (C) 2013-2014 Jerzy Kozera
+** Contact: http://zealdocs.org/contact.html
+**
+** This file is part of Zeal.
+**
+** Zeal is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** Zeal is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Zeal. If not, see <http://www.gnu.org/licenses/>.
+**
+****************************************************************************/
+
+#include "indexedsearchstrategy.h"
+
+#include "docset.h"
+#include "searchquery.h"
+#include "searchresult.h"
+#include "searchstatistics.h"
+#include "symbolindex.h"
+
+using namespace Zeal;
+
+IndexedSearchStrategy::IndexedSearchStrategy(Docset *docset,
+                                             std::unique_ptr<DocsetSearchStrategy> fallback)
+    : m_docset(docset),
+      m_fallback(std::move(fallback))
+{
+}
+
+QList<SearchResult> IndexedSearchStrategy::search(const SearchQuery &searchQuery, CancellationToken token)
+{
+    QList<SearchResult> results;
+    QVector<int> matches;
+    if (!searchSymbols(searchQuery, nullptr, token, results, matches))
+        return m_fallback->search(searchQuery, token);
+    return results;
+}
+
+bool IndexedSearchStrategy::searchSymbols(const SearchQuery &searchQuery, const QVector<int> *candidates,
+                                          CancellationToken token, QList<SearchResult> &results,
+                                          QVector<int> &matches)
+{
+    const SymbolIndex *index = m_docset->symbolIndex();
+    if (!index)
+        return false;
+
+    const std::shared_ptr<const Docset> docset = m_docset->shared_from_this();
+    const auto searchShard = [&](int first, int last, SearchResultHeap &heap, QVector<int> &shardMatches) {
+        {
+            SearchStatistics::Timer timer(SearchStatistics::Stage::IndexMatch);
+            shardMatches = candidates
+                    ? index->find(searchQuery.query(), candidates->constData() + first,
+                                  candidates->constData() + last, token)
+                    : index->find(searchQuery.query(), first, last, token);
+        }
+
+        // Keep the best results of all matches rather than the first ones found
+        SearchStatistics::Timer timer(SearchStatistics::Stage::Scoring);
+        for (int id : shardMatches) {
+            const int score = Docset::scoreSubstringResult(searchQuery, index, id);
+            SearchResult result = SearchResult::fromIndex(docset, index, id, score);
+            result.updateSortKey(searchQuery.query());
+            heap.push(result);
+        }
+    };
+
+    searchShards(candidates ? candidates->size() : index->symbolCount(), searchShard, results, matches);
+    return true;
+}
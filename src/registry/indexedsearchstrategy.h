@@ -0,0 +1,59 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 Oleg Shparber
+** Copyright (C) 2013-2014 Jerzy Kozera
+** Contact: http://zealdocs.org/contact.html
+**
+** This file is part of Zeal.
+**
+** Zeal is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** Zeal is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Zeal. If not, see <http://www.gnu.org/licenses/>.
+**
+****************************************************************************/
+
+#ifndef INDEXEDSEARCHSTRATEGY_H
+#define INDEXEDSEARCHSTRATEGY_H
+
+#include "cancellationtoken.h"
+#include "docsetsearchstrategy.h"
+
+#include <memory>
+
+namespace Zeal {
+
+class Docset;
+
+/**
+ * @brief The IndexedSearchStrategy class
+ * A search strategy that finds symbols in the in-memory SymbolIndex of a docset.
+ *
+ * If the index is not available, e.g. it is still being built or the build
+ * failed, the search is delegated to the fallback strategy.
+ */
+class IndexedSearchStrategy : public DocsetSearchStrategy
+{
+public:
+    IndexedSearchStrategy(Docset *docset, std::unique_ptr<DocsetSearchStrategy> fallback);
+    QList<SearchResult> search(const SearchQuery &searchQuery, CancellationToken token) override;
+    bool searchSymbols(const SearchQuery &searchQuery, const QVector<int> *candidates,
+                       CancellationToken token, QList<SearchResult> &results,
+                       QVector<int> &matches) override;
+
+private:
+    Docset *m_docset;
+    std::unique_ptr<DocsetSearchStrategy> m_fallback;
+};
+
+}
+
+#endif // INDEXEDSEARCHSTRATEGY_H
@@ -53,7 +53,7 @@ void InstalledDocsetModel::populateModelData()
 {
     removeRows(0, rowCount());
     int row = 0;
-    for (Docset *docset: m_registry->docsets()) {
+    for (const std::shared_ptr<Docset> &docset : m_registry->docsets()) {
         QStandardItem *docsetColumn = new QStandardItem(docset->icon(), docset->name());
         QSize size(docsetColumn->sizeHint().width(), 12);
         docsetColumn->setSizeHint(size);
@@ -26,6 +26,9 @@
 #include "docset.h"
 #include "docsetregistry.h"
 
+#include <algorithm>
+#include <QDir>
+
 using namespace Zeal;
 
 ListModel::ListModel(DocsetRegistry *docsetRegistry, QObject *parent) :
@@ -34,6 +37,7 @@ ListModel::ListModel(DocsetRegistry *docsetRegistry, QObject *parent) :
 {
     connect(m_docsetRegistry, &DocsetRegistry::docsetAdded, this, &ListModel::addDocset);
     connect(m_docsetRegistry, &DocsetRegistry::docsetAboutToBeRemoved, this, &ListModel::removeDocset);
+    connect(m_docsetRegistry, &DocsetRegistry::docsetOpened, this, &ListModel::insertGroups);
 
     for (const QString &name : m_docsetRegistry->names())
         addDocset(name);
@@ -56,7 +60,7 @@ QVariant ListModel::data(const QModelIndex &index, int role) const
     case Qt::DecorationRole:
         switch (indexLevel(index)) {
         case Level::DocsetLevel:
-            return m_docsetRegistry->docset(index.row())->icon();
+            return m_docsetItems.at(index.row())->docset->icon();
         case Level::GroupLevel: {
             DocsetItem *docsetItem = reinterpret_cast<DocsetItem *>(index.internalPointer());
             const QString symbolType = docsetItem->groups.at(index.row())->symbolType;
@@ -73,22 +77,22 @@ QVariant ListModel::data(const QModelIndex &index, int role) const
         switch (indexLevel(index)) {
         case Level::DocsetLevel:
             if (!index.column())
-                return m_docsetRegistry->docset(index.row())->title();
+                return m_docsetItems.at(index.row())->docset->title();
             else
-                return m_docsetRegistry->docset(index.row())->indexFilePath();
+                return m_docsetItems.at(index.row())->docset->indexFilePath();
         case Level::GroupLevel: {
-            DocsetItem *docsetItem = reinterpret_cast<DocsetItem *>(index.internalPointer());
-            const QString symbolType = docsetItem->groups.at(index.row())->symbolType;
-            return QString(QLatin1String("%1 (%2)")).arg(pluralize(symbolType),
-                                                         QString::number(docsetItem->docset->symbolCount(symbolType)));
+            const GroupItem *item = groupItemAt(index);
+            return QString(QLatin1String("%1 (%2)")).arg(pluralize(item->symbolType),
+                                                         QString::number(item->symbolCount));
         }
         case Level::SymbolLevel: {
             GroupItem *groupItem = reinterpret_cast<GroupItem *>(index.internalPointer());
-            auto it = groupItem->docsetItem->docset->symbols(groupItem->symbolType).cbegin() + index.row();
+            const Docset *docset = groupItem->docsetItem->docset.get();
+            const Docset::Symbol symbol = docset->symbol(groupItem->symbolType, index.row());
             if (!index.column())
-                return it.key();
+                return symbol.name;
             else
-                return it.value();
+                return QDir(docset->documentPath()).absoluteFilePath(symbol.path);
         }
         default:
             return QVariant();
@@ -96,11 +100,11 @@ QVariant ListModel::data(const QModelIndex &index, int role) const
     case DocsetNameRole:
         if (index.parent().isValid())
             return QVariant();
-        return m_docsetRegistry->docset(index.row())->name();
+        return m_docsetItems.at(index.row())->name;
     case UpdateAvailableRole:
         if (index.parent().isValid())
             return QVariant();
-        return m_docsetRegistry->docset(index.row())->hasUpdate;
+        return m_docsetItems.at(index.row())->docset->hasUpdate;
     default:
         return QVariant();
     }
@@ -115,8 +119,8 @@ QModelIndex ListModel::index(int row, int column, const QModelIndex &parent) con
     case Level::RootLevel:
         return createIndex(row, column);
     case Level::DocsetLevel: {
-        auto it = m_docsetItems.begin() + parent.row();
-        return createIndex(row, column, reinterpret_cast<void *>(it.value()));
+        DocsetItem *docsetItem = m_docsetItems.at(parent.row());
+        return createIndex(row, column, reinterpret_cast<void *>(docsetItem));
     }
     case Level::GroupLevel: {
         DocsetItem *docsetItem = reinterpret_cast<DocsetItem *>(parent.internalPointer());
@@ -132,11 +136,11 @@ QModelIndex ListModel::parent(const QModelIndex &child) const
     switch (indexLevel(child)) {
     case Level::GroupLevel: {
         DocsetItem *item = reinterpret_cast<DocsetItem *>(child.internalPointer());
-        return createIndex(m_docsetItems.keys().indexOf(item->docset->name()), 0);
+        return createIndex(item->row, 0);
     }
     case SymbolLevel: {
         GroupItem *item = reinterpret_cast<GroupItem *>(child.internalPointer());
-        return createIndex(item->docsetItem->groups.indexOf(item), 0, item->docsetItem);
+        return createIndex(item->row, 0, item->docsetItem);
     }
     default:
         return QModelIndex();
@@ -158,54 +162,180 @@ int ListModel::rowCount(const QModelIndex &parent) const
 
     switch (indexLevel(parent)) {
     case Level::RootLevel:
-        return m_docsetRegistry->count();
-    case Level::DocsetLevel:
-        return m_docsetRegistry->docset(parent.row())->symbolCounts().count();
-    case Level::GroupLevel: {
-        DocsetItem *docsetItem = reinterpret_cast<DocsetItem *>(parent.internalPointer());
-        return docsetItem->docset->symbolCount(docsetItem->groups.at(parent.row())->symbolType);
+        return m_docsetItems.size();
+    case Level::DocsetLevel: {
+        DocsetItem *docsetItem = m_docsetItems.at(parent.row());
+        return ensureGroups(docsetItem) ? docsetItem->groups.count() : 0;
     }
+    case Level::GroupLevel:
+        return groupItemAt(parent)->fetchedCount;
     default:
         return 0;
     }
 }
 
+bool ListModel::hasChildren(const QModelIndex &parent) const
+{
+    switch (indexLevel(parent)) {
+    case Level::DocsetLevel:
+        // Do not open docsets just to draw the expand indicator
+        return parent.column() == 0;
+    case Level::GroupLevel:
+        return parent.column() == 0 && groupItemAt(parent)->symbolCount > 0;
+    default:
+        return QAbstractItemModel::hasChildren(parent);
+    }
+}
+
+bool ListModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (indexLevel(parent) != Level::GroupLevel || parent.column() > 0)
+        return false;
+
+    const GroupItem *item = groupItemAt(parent);
+    return item->fetchedCount < item->symbolCount;
+}
+
+void ListModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent))
+        return;
+
+    GroupItem *item = groupItemAt(parent);
+    const int remaining = item->symbolCount - item->fetchedCount;
+    const int count = remaining < Docset::SymbolPageSize ? remaining : Docset::SymbolPageSize;
+
+    beginInsertRows(parent, item->fetchedCount, item->fetchedCount + count - 1);
+    item->fetchedCount += count;
+    endInsertRows();
+}
+
 void ListModel::addDocset(const QString &name)
 {
-    const int index = m_docsetRegistry->names().indexOf(name);
+    // The docset holds on until its row is removed, even if the registry drops it first
+    const std::shared_ptr<Docset> docset = m_docsetRegistry->snapshot()->value(name);
+    if (!docset)
+        return;
+
+    removeDocset(name);
+
+    const int index = lowerBound(name);
     beginInsertRows(QModelIndex(), index, index);
 
+    // Symbol groups are loaded when the docset is expanded
     DocsetItem *docsetItem = new DocsetItem();
-    docsetItem->docset = m_docsetRegistry->docset(name);
-
-    for (const QString &symbolType : docsetItem->docset->symbolCounts().keys()) {
-        GroupItem *groupItem = new GroupItem();
-        groupItem->docsetItem = docsetItem;
-        groupItem->symbolType = symbolType;
-        docsetItem->groups.append(groupItem);
-    }
+    docsetItem->name = name;
+    docsetItem->docset = docset;
 
-    m_docsetItems.insert(name, docsetItem);
+    m_docsetItems.insert(index, docsetItem);
+    updateRows(index);
 
     endInsertRows();
 }
 
 void ListModel::removeDocset(const QString &name)
 {
-    const int index = m_docsetItems.keys().indexOf(name);
+    const int index = lowerBound(name);
     /// TODO: Investigate why this can happen (see #420)
-    if (index == -1)
+    if (index == m_docsetItems.size() || m_docsetItems.at(index)->name != name)
         return;
 
     beginRemoveRows(QModelIndex(), index, index);
 
-    DocsetItem *docsetItem = m_docsetItems.take(name);
+    DocsetItem *docsetItem = m_docsetItems.takeAt(index);
     qDeleteAll(docsetItem->groups);
     delete docsetItem;
+    updateRows(index);
 
     endRemoveRows();
 }
 
+int ListModel::lowerBound(const QString &name) const
+{
+    auto it = std::lower_bound(m_docsetItems.cbegin(), m_docsetItems.cend(), name,
+                               [](const DocsetItem *item, const QString &name) {
+        return item->name < name;
+    });
+    return it - m_docsetItems.cbegin();
+}
+
+void ListModel::updateRows(int first)
+{
+    for (int i = first; i < m_docsetItems.size(); ++i)
+        m_docsetItems.at(i)->row = i;
+}
+
+void ListModel::insertGroups(const QString &name)
+{
+    const int index = lowerBound(name);
+    if (index == m_docsetItems.size() || m_docsetItems.at(index)->name != name)
+        return;
+
+    // The item may have been replaced by a docset that is not open yet, its groups follow then
+    DocsetItem *docsetItem = m_docsetItems.at(index);
+    if (docsetItem->groupsLoaded || !docsetItem->isOpenRequested || !docsetItem->docset->isOpen())
+        return;
+
+    const int count = docsetItem->docset->symbolCounts().size();
+    if (count == 0) {
+        docsetItem->groupsLoaded = true;
+        return;
+    }
+
+    beginInsertRows(createIndex(index, 0), 0, count - 1);
+    loadGroups(docsetItem);
+    endInsertRows();
+}
+
+/**
+ * @brief ListModel::ensureGroups
+ * Returns true if groups of \a docsetItem are loaded. The first expansion of a docset
+ * that is not open yet has the registry open it in background, its groups are inserted
+ * once it is open, so that the GUI thread does not wait for the database.
+ */
+bool ListModel::ensureGroups(DocsetItem *docsetItem) const
+{
+    if (docsetItem->groupsLoaded)
+        return true;
+
+    if (docsetItem->isOpenRequested)
+        return false;
+
+    if (!docsetItem->docset->isOpen()) {
+        docsetItem->isOpenRequested = true;
+        m_docsetRegistry->openDocset(docsetItem->name);
+        return false;
+    }
+
+    loadGroups(docsetItem);
+    return true;
+}
+
+void ListModel::loadGroups(DocsetItem *docsetItem)
+{
+    if (docsetItem->groupsLoaded)
+        return;
+
+    const QMap<QString, int> symbolCounts = docsetItem->docset->symbolCounts();
+    for (auto it = symbolCounts.cbegin(); it != symbolCounts.cend(); ++it) {
+        GroupItem *groupItem = new GroupItem();
+        groupItem->row = docsetItem->groups.size();
+        groupItem->docsetItem = docsetItem;
+        groupItem->symbolType = it.key();
+        groupItem->symbolCount = it.value();
+        docsetItem->groups.append(groupItem);
+    }
+
+    docsetItem->groupsLoaded = true;
+}
+
+/// Returns the group of a GroupLevel \a index.
+ListModel::GroupItem *ListModel::groupItemAt(const QModelIndex &index) const
+{
+    DocsetItem *docsetItem = reinterpret_cast<DocsetItem *>(index.internalPointer());
+    return docsetItem->groups.at(index.row());
+}
+
 QString ListModel::pluralize(const QString &s)
 {
     if (s.endsWith(QLatin1String("y")))
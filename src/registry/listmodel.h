@@ -24,8 +24,9 @@
 #ifndef LISTMODEL_H
 #define LISTMODEL_H
 
+#include <memory>
 #include <QAbstractListModel>
-#include <QMap>
+#include <QVector>
 
 namespace Zeal {
 
@@ -53,10 +54,14 @@ public:
     QModelIndex parent(const QModelIndex &child) const override;
     int columnCount(const QModelIndex &parent) const override;
     int rowCount(const QModelIndex &parent) const override;
+    bool hasChildren(const QModelIndex &parent) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
 
 private slots:
     void addDocset(const QString &name);
     void removeDocset(const QString &name);
+    void insertGroups(const QString &name);
 
 private:
     enum Level {
@@ -71,20 +76,37 @@ private:
 
     DocsetRegistry *m_docsetRegistry = nullptr;
 
+    // Items keep their row, so parent() does not have to look it up
     struct DocsetItem;
     struct GroupItem {
         const Level level = Level::GroupLevel;
+        int row = 0;
         DocsetItem *docsetItem = nullptr;
         QString symbolType;
+        int symbolCount = 0;
+        // Symbols are shown page by page as the view asks for more
+        int fetchedCount = 0;
     };
 
     struct DocsetItem {
         const Level level = Level::DocsetLevel;
-        Docset *docset = nullptr;
+        int row = 0;
+        QString name;
+        std::shared_ptr<Docset> docset;
+        bool groupsLoaded = false;
+        // Groups of a docset opened on request are inserted by insertGroups()
+        bool isOpenRequested = false;
         QList<GroupItem *> groups;
     };
 
-    QMap<QString, DocsetItem *> m_docsetItems;
+    bool ensureGroups(DocsetItem *docsetItem) const;
+    static void loadGroups(DocsetItem *docsetItem);
+    GroupItem *groupItemAt(const QModelIndex &index) const;
+    int lowerBound(const QString &name) const;
+    void updateRows(int first);
+
+    // Sorted by name, rows follow the registry order
+    QVector<DocsetItem *> m_docsetItems;
 };
 
 } // namespace Zeal
@@ -0,0 +1,204 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 Oleg Shparber
+** Copyright (C) 2013-2014 Jerzy Kozera
+** Contact: http://zealdocs.org/contact.html
+**
+** This file is part of Zeal.
+**
+** Zeal is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** Zeal is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Zeal. If not, see <http://www.gnu.org/licenses/>.
+**
+****************************************************************************/
+
+#include "prefixcache.h"
+
+using namespace Zeal;
+
+namespace Zeal {
+
+struct PrefixCache::Node
+{
+    Node *parent = nullptr;
+    const void *owner = nullptr;
+    QChar key;
+    QHash<QChar, Node *> children;
+
+    PrefixCache::Ids ids;
+    std::list<Node *>::iterator lruIterator;
+};
+
+} // namespace Zeal
+
+PrefixCache::PrefixCache(qint64 budget) :
+    m_budget(budget)
+{
+}
+
+PrefixCache::~PrefixCache()
+{
+    for (Node *root : m_roots)
+        deleteTree(root);
+}
+
+PrefixCache *PrefixCache::instance()
+{
+    static PrefixCache cache;
+    return &cache;
+}
+
+PrefixCache::Ids PrefixCache::find(const void *owner, const QString &query, int *prefixLength)
+{
+    QMutexLocker locker(&m_mutex);
+
+    Node *node = m_roots.value(owner);
+    Node *found = node && node->ids ? node : nullptr;
+    int foundLength = 0;
+    for (int i = 0; node && i < query.size(); ++i) {
+        node = node->children.value(query.at(i));
+        if (node && node->ids) {
+            found = node;
+            foundLength = i + 1;
+        }
+    }
+
+    if (prefixLength)
+        *prefixLength = foundLength;
+    if (!found)
+        return nullptr;
+
+    m_lru.splice(m_lru.begin(), m_lru, found->lruIterator);
+    return found->ids;
+}
+
+void PrefixCache::insert(const void *owner, const QString &query, const QVector<int> &ids)
+{
+    // Candidate sets of short prefixes can be large, do not keep spare capacity around
+    QVector<int> compactIds(ids);
+    compactIds.squeeze();
+
+    Ids entry = std::make_shared<const QVector<int>>(compactIds);
+    if (entrySize(entry) > budget())
+        return;
+
+    QMutexLocker locker(&m_mutex);
+
+    Node *&root = m_roots[owner];
+    if (!root) {
+        root = new Node();
+        root->owner = owner;
+    }
+
+    Node *node = root;
+    for (int i = 0; i < query.size(); ++i) {
+        Node *&child = node->children[query.at(i)];
+        if (!child) {
+            child = new Node();
+            child->parent = node;
+            child->owner = owner;
+            child->key = query.at(i);
+        }
+        node = child;
+    }
+
+    if (node->ids)
+        releaseEntry(node);
+
+    node->ids = entry;
+    m_size += entrySize(entry);
+    m_lru.push_front(node);
+    node->lruIterator = m_lru.begin();
+
+    evict();
+}
+
+void PrefixCache::remove(const void *owner)
+{
+    QMutexLocker locker(&m_mutex);
+
+    Node *root = m_roots.take(owner);
+    if (!root)
+        return;
+
+    for (auto it = m_lru.begin(); it != m_lru.end();) {
+        if ((*it)->owner == owner) {
+            m_size -= entrySize((*it)->ids);
+            it = m_lru.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    deleteTree(root);
+}
+
+qint64 PrefixCache::budget() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_budget;
+}
+
+void PrefixCache::setBudget(qint64 budget)
+{
+    QMutexLocker locker(&m_mutex);
+    m_budget = budget;
+    evict();
+}
+
+qint64 PrefixCache::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_size;
+}
+
+qint64 PrefixCache::entrySize(const Ids &ids)
+{
+    return sizeof(Node) + ids->size() * sizeof(int);
+}
+
+void PrefixCache::evict()
+{
+    while (m_size > m_budget && !m_lru.empty()) {
+        Node *node = m_lru.back();
+        releaseEntry(node);
+        prune(node);
+    }
+}
+
+void PrefixCache::releaseEntry(Node *node)
+{
+    m_size -= entrySize(node->ids);
+    m_lru.erase(node->lruIterator);
+    node->ids.reset();
+}
+
+/// Deletes \a node and its ancestors as long as they have neither entries nor children.
+void PrefixCache::prune(Node *node)
+{
+    while (node && !node->ids && node->children.isEmpty()) {
+        Node *parent = node->parent;
+        if (parent)
+            parent->children.remove(node->key);
+        else
+            m_roots.remove(node->owner);
+        delete node;
+        node = parent;
+    }
+}
+
+void PrefixCache::deleteTree(Node *node)
+{
+    for (Node *child : node->children)
+        deleteTree(child);
+    delete node;
+}
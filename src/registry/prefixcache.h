@@ -0,0 +1,90 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 Oleg Shparber
+** Copyright (C) 2013-2014 Jerzy Kozera
+** Contact: http://zealdocs.org/contact.html
+**
+** This file is part of Zeal.
+**
+** Zeal is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** Zeal is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Zeal. If not, see <http://www.gnu.org/licenses/>.
+**
+****************************************************************************/
+
+#ifndef PREFIXCACHE_H
+#define PREFIXCACHE_H
+
+#include <list>
+#include <memory>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+namespace Zeal {
+
+/**
+ * @brief The PrefixCache class
+ * A byte-budgeted cache of symbol ids matching previous queries, shared by all docsets.
+ *
+ * Entries of every owner (a search strategy of a docset) are kept in a trie
+ * keyed by query characters, so the longest cached prefix of a query is
+ * found in a single walk. As the ids matching a query are a subset of the
+ * ids matching any of its prefixes, only those ids need to be searched.
+ *
+ * The least recently used entries are evicted once the ids exceed the budget.
+ */
+class PrefixCache
+{
+public:
+    typedef std::shared_ptr<const QVector<int>> Ids;
+
+    explicit PrefixCache(qint64 budget = DefaultBudget);
+    ~PrefixCache();
+
+    static PrefixCache *instance();
+
+    /// Returns sorted ids of the longest cached prefix of \a query, or nullptr.
+    Ids find(const void *owner, const QString &query, int *prefixLength = nullptr);
+    /// Stores sorted \a ids of all symbols that match \a query.
+    void insert(const void *owner, const QString &query, const QVector<int> &ids);
+    /// Drops all entries of \a owner, must be called before the owner is destroyed.
+    void remove(const void *owner);
+
+    qint64 budget() const;
+    void setBudget(qint64 budget);
+    /// Returns the number of bytes used by cached ids.
+    qint64 size() const;
+
+    static const qint64 DefaultBudget = 32 * 1024 * 1024;
+
+private:
+    struct Node;
+
+    static qint64 entrySize(const Ids &ids);
+    static void deleteTree(Node *node);
+    void evict();
+    void releaseEntry(Node *node);
+    void prune(Node *node);
+
+    mutable QMutex m_mutex;
+    qint64 m_budget;
+    qint64 m_size = 0;
+    QHash<const void *, Node *> m_roots;
+    // Nodes with entries, most recently used first
+    std::list<Node *> m_lru;
+};
+
+} // namespace Zeal
+
+#endif // PREFIXCACHE_H
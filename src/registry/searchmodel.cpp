@@ -24,7 +24,9 @@
 #include "searchmodel.h"
 
 #include "registry/docset.h"
+#include "registry/searchstatistics.h"
 
+#include <algorithm>
 #include <QDir>
 
 using namespace Zeal;
@@ -45,12 +47,12 @@ QVariant SearchModel::data(const QModelIndex &index, int role) const
     case Qt::DisplayRole:
         switch (index.column()) {
         case 0:
-            if (item->parentName.isEmpty())
-                return item->name;
+            if (item->parentName().isEmpty())
+                return item->name();
             else
-                return QString("%1 (%2)").arg(item->name, item->parentName);
+                return QString("%1 (%2)").arg(item->name(), item->parentName());
         case 1:
-            return QDir(item->docset->documentPath()).absoluteFilePath(item->path);
+            return QDir(item->docset->documentPath()).absoluteFilePath(item->path());
         default:
             return QVariant();
         }
@@ -64,7 +66,7 @@ QVariant SearchModel::data(const QModelIndex &index, int role) const
     case Roles::TypeIconRole:
         if (index.column() != 0)
             return QVariant();
-        return QIcon(QString("typeIcon:%1.png").arg(item->type));
+        return QIcon(QString("typeIcon:%1.png").arg(item->type()));
 
     default:
         return QVariant();
@@ -102,8 +104,49 @@ int SearchModel::columnCount(const QModelIndex &parent) const
 
 void SearchModel::setResults(const QList<SearchResult> &results)
 {
-    beginResetModel();
-    m_dataList = results;
-    endResetModel();
+    {
+        SearchStatistics::Timer timer(SearchStatistics::Stage::Model);
+        beginResetModel();
+        m_dataList = results;
+        endResetModel();
+    }
     emit queryCompleted();
 }
+
+/**
+ * @brief SearchModel::addResults
+ * Merges sorted \a results into the current sorted results without resetting the model.
+ * Only the best \a maxCount results are kept.
+ */
+void SearchModel::addResults(const QList<SearchResult> &results, int maxCount)
+{
+    SearchStatistics::Timer timer(SearchStatistics::Stage::Model);
+
+    int from = 0;
+    int i = 0;
+    while (i < results.size()) {
+        const int row = std::upper_bound(m_dataList.begin() + from, m_dataList.end(), results.at(i))
+                - m_dataList.begin();
+
+        // Insert every following result that goes before the same existing row in one go
+        int count = 1;
+        while (i + count < results.size()
+               && (row == m_dataList.size() || results.at(i + count) < m_dataList.at(row))) {
+            ++count;
+        }
+
+        beginInsertRows(QModelIndex(), row, row + count - 1);
+        for (int j = 0; j < count; ++j)
+            m_dataList.insert(row + j, results.at(i + j));
+        endInsertRows();
+
+        i += count;
+        from = row + count;
+    }
+
+    if (m_dataList.size() > maxCount) {
+        beginRemoveRows(QModelIndex(), maxCount, m_dataList.size() - 1);
+        m_dataList.erase(m_dataList.begin() + maxCount, m_dataList.end());
+        endRemoveRows();
+    }
+}
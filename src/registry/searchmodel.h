@@ -53,6 +53,7 @@ public:
 
 public slots:
     void setResults(const QList<SearchResult> &results = QList<SearchResult>());
+    void addResults(const QList<SearchResult> &results, int maxCount);
 
 signals:
     void queryCompleted();
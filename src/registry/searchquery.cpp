@@ -25,6 +25,7 @@
 
 #include "docset.h"
 #include "docsetkeywords.h"
+#include "symbolindex.h"
 
 #include <QString>
 
@@ -41,9 +42,12 @@ SearchQuery::SearchQuery()
 
 SearchQuery::SearchQuery(const QString &query,
                          const QString &keywordPrefix,
-                         const QStringList &docsets)
+                         const DocsetKeywords &docsetKeywords,
+                         const QBitArray &docsets)
    : m_query(query),
+     m_foldedQuery(SymbolIndex::foldCase(query)),
      m_keywordPrefix(keywordPrefix),
+     m_docsetKeywords(docsetKeywords),
      m_enabledDocsets(docsets)
 {
 }
@@ -54,14 +58,14 @@ SearchQuery::SearchQuery(const QString &query,
  *
  * @param str String representation of a query.
  */
-SearchQuery SearchQuery::fromString(const QString &str, const DocsetKeywords docsetKeywords)
+SearchQuery SearchQuery::fromString(const QString &str, const DocsetKeywords &docsetKeywords)
 {
     const int sepAt = str.indexOf(prefixSeparator);
     const int next = sepAt + 1;
 
     QString query;
     QString keywordStr;
-    QStringList docsets;
+    QBitArray docsets;
 
     // Try to get keywords from the query.
     if (sepAt > 0) {
@@ -71,7 +75,7 @@ SearchQuery SearchQuery::fromString(const QString &str, const DocsetKeywords doc
 
     // If keywords were found then query should not include the keywords.
     // Otherwise query should include entire str.
-    if (docsets.size() > 0) {
+    if (!docsets.isEmpty()) {
         query = str.mid(next).trimmed();
         keywordStr = keywordStr + ":";
     } else {
@@ -79,16 +83,23 @@ SearchQuery SearchQuery::fromString(const QString &str, const DocsetKeywords doc
         keywordStr = QString();
     }
 
-    return SearchQuery(query, keywordStr, docsets);
+    return SearchQuery(query, keywordStr, docsetKeywords, docsets);
 }
 
-QStringList SearchQuery::tryGetKeywords(QString keywordStr, DocsetKeywords docsetKeywords)
+QBitArray SearchQuery::tryGetKeywords(const QString &keywordStr, const DocsetKeywords &docsetKeywords)
 {
-    QStringList docsets;
-    QStringList candidateKeywords = keywordStr.split(keywordSeparator);
+    QBitArray docsets;
+    const QStringList candidateKeywords = keywordStr.split(keywordSeparator);
 
-    for (QString candidate: candidateKeywords)
-        docsets += docsetKeywords.getKeywordDocsets(candidate);
+    for (const QString &candidate : candidateKeywords) {
+        if (!docsetKeywords.contains(candidate))
+            continue;
+
+        if (docsets.isEmpty())
+            docsets = docsetKeywords.getKeywordDocsets(candidate);
+        else
+            docsets |= docsetKeywords.getKeywordDocsets(candidate);
+    }
 
     return docsets;
 }
@@ -112,7 +123,26 @@ void SearchQuery::setKeywordPrefix(const QString &keywordPrefix)
 
 bool SearchQuery::isEnabled(const Docset *docset) const
 {
-    return m_enabledDocsets.size() == 0 || m_enabledDocsets.contains(docset->name());
+    if (m_enabledDocsets.isEmpty())
+        return true;
+
+    const int index = m_docsetKeywords.indexOf(docset);
+    return index != -1 && m_enabledDocsets.testBit(index);
+}
+
+bool SearchQuery::hasDocsetFilter() const
+{
+    return !m_enabledDocsets.isEmpty();
+}
+
+QBitArray SearchQuery::enabledDocsets() const
+{
+    return m_enabledDocsets;
+}
+
+DocsetKeywords SearchQuery::docsetKeywords() const
+{
+    return m_docsetKeywords;
 }
 
 int SearchQuery::keywordPrefixSize() const
@@ -128,6 +158,22 @@ QString SearchQuery::query() const
 void SearchQuery::setQuery(const QString &str)
 {
     m_query = str;
+    m_foldedQuery = SymbolIndex::foldCase(str);
+}
+
+bool SearchQuery::isFuzzy() const
+{
+    return m_isFuzzy;
+}
+
+void SearchQuery::setFuzzy(bool fuzzy)
+{
+    m_isFuzzy = fuzzy;
+}
+
+QString SearchQuery::foldedQuery() const
+{
+    return m_foldedQuery;
 }
 
 QString SearchQuery::sanitizedQuery() const
@@ -24,12 +24,14 @@
 #ifndef SEARCHQUERY_H
 #define SEARCHQUERY_H
 
+#include "docsetkeywords.h"
+
+#include <QBitArray>
 #include <QStringList>
 
 namespace Zeal {
 
 class Docset;
-class DocsetKeywords;
 
 /**
  * @short The search query model.
@@ -40,7 +42,8 @@ public:
     explicit SearchQuery();
     explicit SearchQuery(const QString &query,
             const QString &keywordPrefix = QString(),
-            const QStringList &docsets = QStringList());
+            const DocsetKeywords &docsetKeywords = DocsetKeywords(),
+            const QBitArray &docsets = QBitArray());
 
     /**
      * @brief fromString
@@ -65,7 +68,7 @@ public:
      * @param docsetKeywords List of currently enabled keywords.
      * @return A query with keywords.
      */
-    static SearchQuery fromString(const QString &str, const DocsetKeywords docsetKeywords);
+    static SearchQuery fromString(const QString &str, const DocsetKeywords &docsetKeywords);
 
     QString toString() const;
 
@@ -76,19 +79,36 @@ public:
     /// Returns true if the docset falls satisfies a docset filter.
     bool isEnabled(const Docset* docset) const;
 
+    /// Returns true if the query is limited to docsets of its keywords.
+    bool hasDocsetFilter() const;
+    /// Returns enabled docsets as a bitset of DocsetKeywords::indexOf() indexes.
+    QBitArray enabledDocsets() const;
+    /// Returns the keywords the query was parsed with.
+    DocsetKeywords docsetKeywords() const;
+
     /// Returns the docset filter raw size for the given query
     int keywordPrefixSize() const;
 
     QString query() const;
     void setQuery(const QString &str);
 
+    /// Whether symbols are matched by subsequence rather than by substring
+    bool isFuzzy() const;
+    void setFuzzy(bool fuzzy);
+
+    /// Returns the core query case folded the same way as symbol index names
+    QString foldedQuery() const;
+
     /// Returns the core query, sanitized for use in SQL queries
     QString sanitizedQuery() const;
 
 private:
     QString m_query;
+    QString m_foldedQuery;
     QString m_keywordPrefix;
-    QStringList m_enabledDocsets;
+    DocsetKeywords m_docsetKeywords;
+    QBitArray m_enabledDocsets; // Empty if all docsets are enabled
+    bool m_isFuzzy = false;
 
     /**
      * @brief tryGetKeywords
@@ -97,10 +117,10 @@ private:
      *
      * @param keywordStr Comma separated list of keywords.
      * @param docsetKeywords List of available keywords.
-     * @return If any of the keywords is not available returns an empty list.
-     * Otherwise returns the list of all keywords.
+     * @return If none of the keywords is available returns an empty bitset.
+     * Otherwise returns docsets of all available keywords.
      */
-    static QStringList tryGetKeywords(QString keywordStr, DocsetKeywords docsetKeywords);
+    static QBitArray tryGetKeywords(const QString &keywordStr, const DocsetKeywords &docsetKeywords);
 };
 
 QDataStream &operator<<(QDataStream &out, const SearchQuery &query);
@@ -23,29 +23,153 @@
 
 #include "searchresult.h"
 
+#include "symbolindex.h"
+
+#include <algorithm>
+#include <functional>
+
 using namespace Zeal;
 
+namespace {
+// Number of name characters packed into a sort key
+const int SortKeyPrefixLength = 3;
+const quint64 SortKeyPrefixMask = (quint64(1) << (16 * SortKeyPrefixLength)) - 1;
+}
+
+SearchResult SearchResult::fromIndex(const std::shared_ptr<const Docset> &docset, const SymbolIndex *index,
+                                     int symbolId, int score)
+{
+    return SearchResult{docset, index, symbolId, score, false, 0, QSharedPointer<const Strings>()};
+}
+
+SearchResult SearchResult::fromStrings(const std::shared_ptr<const Docset> &docset, const QString &name,
+                                       const QString &type, const QString &path, int score, bool isHeader)
+{
+    QSharedPointer<const Strings> strings(new Strings{name, QString(), type, path});
+    return SearchResult{docset, nullptr, -1, score, isHeader, 0, strings};
+}
+
+QString SearchResult::name() const
+{
+    return index ? index->name(symbolId) : strings->name;
+}
+
+QString SearchResult::parentName() const
+{
+    return index ? QString() : strings->parentName;
+}
+
+QString SearchResult::type() const
+{
+    return index ? index->type(symbolId) : strings->type;
+}
+
+QString SearchResult::path() const
+{
+    return index ? index->path(symbolId) : strings->path;
+}
+
+QString SearchResult::nameRef() const
+{
+    return index ? index->nameRef(symbolId) : strings->name;
+}
+
 bool SearchResult::operator<(const SearchResult &r) const
 {
+    if (sortKey != r.sortKey)
+        return sortKey > r.sortKey;
+
     if (score != r.score)
         return score > r.score;
 
-    const bool lhsStartsWithQuery = name.startsWith(query, Qt::CaseInsensitive);
-    const bool rhsStartsWithQuery = r.name.startsWith(query, Qt::CaseInsensitive);
+    // Symbols in an index are sorted by their case folded names and ids break ties below,
+    // so for two symbols of the same index the id order is the order of the full comparison
+    if (index && index == r.index)
+        return symbolId < r.symbolId;
 
-    if (lhsStartsWithQuery != rhsStartsWithQuery)
-        return lhsStartsWithQuery > rhsStartsWithQuery;
-
-    const int namesCmp = QString::compare(name, r.name, Qt::CaseInsensitive);
+    const int namesCmp = QString::compare(nameRef(), r.nameRef(), Qt::CaseInsensitive);
     if (namesCmp)
         return namesCmp < 0;
 
-    return QString::compare(parentName, r.parentName, Qt::CaseInsensitive) < 0;
+    const int parentNamesCmp = QString::compare(parentName(), r.parentName(), Qt::CaseInsensitive);
+    if (parentNamesCmp)
+        return parentNamesCmp < 0;
+
+    // Keep the ordering strict weak for equal names of different indexes
+    if (index != r.index)
+        return std::less<const SymbolIndex *>()(index, r.index);
+    return symbolId < r.symbolId;
+}
+
+SearchResult SearchResult::withScore(int newScore, const QString &query) const
+{
+    SearchResult result(*this);
+    result.score = newScore;
+    result.updateSortKey(query);
+    return result;
+}
+
+void SearchResult::updateSortKey(const QString &query)
+{
+    // Better results get greater keys: score, then prefix match, then name in ascending order
+    const QString name = nameRef();
+    quint64 prefix = 0;
+    for (int i = 0; i < SortKeyPrefixLength; ++i) {
+        prefix <<= 16;
+        if (i < name.size())
+            prefix |= name.at(i).toCaseFolded().unicode();
+    }
+
+    sortKey = quint64(qBound(0, score, 0x7fff)) << 49;
+    if (name.startsWith(query, Qt::CaseInsensitive))
+        sortKey |= quint64(1) << 48;
+    sortKey |= SortKeyPrefixMask - prefix;
+}
+
+SearchResultHeap::SearchResultHeap(int capacity) :
+    m_capacity(capacity)
+{
+    m_heap.reserve(capacity);
+}
+
+int SearchResultHeap::size() const
+{
+    return m_heap.size();
 }
 
-SearchResult SearchResult::withScore(int newScore) const
+int SearchResultHeap::worstScore() const
 {
-    return SearchResult({name, parentName, type,
-                         docset, path, query,
-                         newScore, isHeader});
+    return static_cast<int>(m_heap.size()) < m_capacity ? 0 : m_heap.front().score;
+}
+
+void SearchResultHeap::push(const SearchResult &result)
+{
+    if (m_capacity <= 0)
+        return;
+
+    if (static_cast<int>(m_heap.size()) < m_capacity) {
+        m_heap.push_back(result);
+        std::push_heap(m_heap.begin(), m_heap.end());
+        return;
+    }
+
+    if (!(result < m_heap.front()))
+        return;
+
+    std::pop_heap(m_heap.begin(), m_heap.end());
+    m_heap.back() = result;
+    std::push_heap(m_heap.begin(), m_heap.end());
+}
+
+QList<SearchResult> SearchResultHeap::takeSorted()
+{
+    std::sort_heap(m_heap.begin(), m_heap.end());
+
+    QList<SearchResult> results;
+    results.reserve(m_heap.size());
+    for (const SearchResult &result : m_heap)
+        results.append(result);
+
+    m_heap.clear();
+    return results;
 }
@@ -24,38 +24,109 @@
 #ifndef SEARCHRESULT_H
 #define SEARCHRESULT_H
 
+#include <memory>
+#include <QList>
+#include <QMetaType>
+#include <QSharedPointer>
 #include <QString>
 
+#include <vector>
+
 namespace Zeal {
 
 class Docset;
+class SymbolIndex;
 
 /**
  * @brief The SearchResult struct
  * Contains a single item of the search results/see also list.
+ *
+ * Results found in a symbol index only refer to the symbol by its id, so
+ * they can be created, copied and cached without allocating strings. Other
+ * results share their strings through \a strings. Strings are created only
+ * when they are displayed.
+ *
+ * A result shares ownership of its docset, so the docset and its index stay
+ * alive while the result is shown, even if the docset is removed meanwhile.
  */
 struct SearchResult
 {
-    QString name;
-    QString parentName;
-    QString type;
+    /// Strings of a result that does not come from a symbol index
+    struct Strings {
+        QString name;
+        QString parentName;
+        QString type;
+        QString path;
+    };
+
+    static SearchResult fromIndex(const std::shared_ptr<const Docset> &docset, const SymbolIndex *index,
+                                  int symbolId, int score);
+    static SearchResult fromStrings(const std::shared_ptr<const Docset> &docset, const QString &name,
+                                    const QString &type, const QString &path, int score = 0,
+                                    bool isHeader = false);
 
-    Docset *docset;
+    QString name() const;
+    QString parentName() const;
+    QString type() const;
+    QString path() const;
 
-    QString path;
+    /// Returns the name without copying it from the index, do not store it.
+    QString nameRef() const;
 
-    /// TODO: Remove
-    QString query;
+    std::shared_ptr<const Docset> docset;
+
+    /// Index the symbol comes from, or nullptr if strings are set
+    const SymbolIndex *index;
+    int symbolId;
 
     int score;
 
     bool isHeader;
 
+    /// Precomputed ordering, see updateSortKey(). Zero if not computed.
+    quint64 sortKey;
+
+    QSharedPointer<const Strings> strings;
+
     bool operator<(const SearchResult &r) const;
 
-    SearchResult withScore(int newScore) const;
+    SearchResult withScore(int newScore, const QString &query) const;
+
+    /**
+     * @brief updateSortKey
+     * Packs score, whether name starts with the \a query, and the first characters
+     * of the case folded name into sortKey, so that most comparisons are a
+     * single integer compare. Must be called after score is changed.
+     */
+    void updateSortKey(const QString &query);
+};
+
+/**
+ * @brief The SearchResultHeap class
+ * Bounded heap that keeps the best results, selecting them in O(n log capacity).
+ */
+class SearchResultHeap
+{
+public:
+    explicit SearchResultHeap(int capacity);
+
+    int size() const;
+    void push(const SearchResult &result);
+
+    /// Returns the score a result needs to be kept, or 0 while the heap is not full.
+    int worstScore() const;
+
+    /// Returns kept results, best first, and clears the heap.
+    QList<SearchResult> takeSorted();
+
+private:
+    int m_capacity;
+    // The worst kept result is at the front
+    std::vector<SearchResult> m_heap;
 };
 
 } // namespace Zeal
 
+Q_DECLARE_METATYPE(Zeal::SearchResult)
+
 #endif // SEARCHRESULT_H
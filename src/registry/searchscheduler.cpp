@@ -0,0 +1,341 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 Oleg Shparber
+** Copyright (C) 2013-2014 Jerzy Kozera
+** Contact: http://zealdocs.org/contact.html
+**
+** This file is part of Zeal.
+**
+** Zeal is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** Zeal is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Zeal. If not, see <http://www.gnu.org/licenses/>.
+**
+****************************************************************************/
+
+#include "searchscheduler.h"
+
+#include <memory>
+#include <QThread>
+
+using namespace Zeal;
+
+namespace {
+const int PriorityCount = 3;
+}
+
+namespace Zeal {
+
+class SearchScheduler::Worker : public QThread
+{
+public:
+    explicit Worker(SearchScheduler *scheduler) :
+        scheduler(scheduler)
+    {
+    }
+
+    SearchScheduler *scheduler;
+    Priority priority = Priority::Interactive; // Of the running task
+
+    QMutex mutex;
+    std::deque<Task> tasks[PriorityCount];
+
+protected:
+    void run() override
+    {
+        scheduler->workerLoop(this);
+    }
+};
+
+} // namespace Zeal
+
+SearchScheduler::SearchScheduler(int workerCount) :
+    m_maxBackgroundTasks(qMax(1, workerCount / 4))
+{
+    for (int i = 0; i < workerCount; ++i) {
+        Worker *worker = new Worker(this);
+        m_workers.append(worker);
+        worker->start();
+    }
+}
+
+SearchScheduler::~SearchScheduler()
+{
+    shutdown();
+}
+
+SearchScheduler *SearchScheduler::instance()
+{
+    static SearchScheduler scheduler(qMax(2, QThread::idealThreadCount()));
+    return &scheduler;
+}
+
+int SearchScheduler::workerCount() const
+{
+    return m_workers.size();
+}
+
+void SearchScheduler::shutdown()
+{
+    // Dropped tasks are cancelled and destroyed unlocked, they may release the last reference to a docset
+    std::deque<Task> droppedTasks;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_isStopping)
+            return;
+        m_isStopping = true;
+
+        const int index = static_cast<int>(Priority::Background);
+        auto takeDropped = [this, &droppedTasks](std::deque<Task> &tasks) {
+            for (auto it = tasks.begin(); it != tasks.end();) {
+                if (isDropped(*it)) {
+                    droppedTasks.push_back(*it);
+                    it = tasks.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        };
+
+        for (Worker *worker : m_workers) {
+            QMutexLocker workerLocker(&worker->mutex);
+            takeDropped(worker->tasks[index]);
+        }
+        takeDropped(m_tasks[index]);
+
+        m_pendingCounts[index] -= static_cast<int>(droppedTasks.size());
+        m_wakeCondition.wakeAll();
+    }
+
+    for (const Task &task : droppedTasks)
+        task.cancel();
+    droppedTasks.clear();
+
+    // Workers finish the remaining tasks before they exit, so no future is left pending.
+    // Running workers steal from the others, so none is deleted before all have exited.
+    for (Worker *worker : m_workers)
+        worker->wait();
+    qDeleteAll(m_workers);
+    m_workers.clear();
+}
+
+void SearchScheduler::runAll(const QVector<std::function<void()>> &functions)
+{
+    if (functions.isEmpty())
+        return;
+
+    struct Join {
+        QMutex mutex;
+        QWaitCondition finished;
+        int remainingCount;
+    };
+
+    std::shared_ptr<Join> join(new Join());
+    join->remainingCount = functions.size() - 1;
+
+    Worker *worker = currentWorker();
+    const Priority priority = worker ? worker->priority : Priority::Interactive;
+    for (int i = 1; i < functions.size(); ++i) {
+        const std::function<void()> function = functions.at(i);
+        schedule(priority, [join, function]() {
+            function();
+
+            QMutexLocker locker(&join->mutex);
+            if (--join->remainingCount == 0)
+                join->finished.wakeAll();
+        });
+    }
+
+    functions.first()();
+
+    // Queued functions are most likely at the back of our own deque
+    Task task;
+    forever {
+        {
+            QMutexLocker locker(&join->mutex);
+            if (join->remainingCount == 0)
+                return;
+        }
+
+        // Subtasks of a background task do not wait for a free background slot
+        if (!takeTask(worker, priority, false, &task))
+            break;
+        runTask(worker, task);
+    }
+
+    // Nothing left to help with, the remaining functions are running
+    QMutexLocker locker(&join->mutex);
+    while (join->remainingCount > 0)
+        join->finished.wait(&join->mutex);
+}
+
+void SearchScheduler::schedule(Priority priority, const std::function<void()> &function,
+                               const std::function<void()> &cancel)
+{
+    const int index = static_cast<int>(priority);
+    const Task task = {function, cancel, priority, false};
+
+    Worker *worker = currentWorker();
+    {
+        QMutexLocker locker(&m_mutex);
+
+        // While stopping, the calling worker is still alive to run tasks of running tasks
+        if (!m_isStopping || (worker && !isDropped(task))) {
+            if (worker) {
+                QMutexLocker workerLocker(&worker->mutex);
+                worker->tasks[index].push_back(task);
+            } else {
+                m_tasks[index].push_back(task);
+            }
+            ++m_pendingCounts[index];
+            m_wakeCondition.wakeOne();
+            return;
+        }
+    }
+
+    if (isDropped(task))
+        task.cancel();
+    else
+        task.function();
+}
+
+/// Returns true if \a task is not run once shutdown() has been called.
+bool SearchScheduler::isDropped(const Task &task) const
+{
+    return task.priority == Priority::Background && task.cancel;
+}
+
+/**
+ * @brief SearchScheduler::takeTask
+ * Takes the highest priority task not lower than \a maxPriority: the newest one
+ * of the own deque, the oldest one of the shared queue, or the oldest one of
+ * another worker.
+ *
+ * Background tasks are only taken while fewer than m_maxBackgroundTasks of them
+ * run, unless \a limitBackground is false.
+ */
+bool SearchScheduler::takeTask(Worker *worker, Priority maxPriority, bool limitBackground, Task *task)
+{
+    for (int index = 0; index <= static_cast<int>(maxPriority); ++index) {
+        const bool isLimited = limitBackground && index == static_cast<int>(Priority::Background);
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_pendingCounts[index] <= 0)
+                continue;
+
+            if (isLimited) {
+                if (m_backgroundTaskCount >= m_maxBackgroundTasks)
+                    continue;
+                ++m_backgroundTaskCount;
+            }
+        }
+
+        bool found = false;
+        if (worker) {
+            QMutexLocker locker(&worker->mutex);
+            if (!worker->tasks[index].empty()) {
+                *task = worker->tasks[index].back();
+                worker->tasks[index].pop_back();
+                found = true;
+            }
+        }
+
+        if (!found) {
+            QMutexLocker locker(&m_mutex);
+            if (!m_tasks[index].empty()) {
+                *task = m_tasks[index].front();
+                m_tasks[index].pop_front();
+                found = true;
+            }
+        }
+
+        for (int i = 0; !found && i < m_workers.size(); ++i) {
+            Worker *victim = m_workers.at(i);
+            if (victim == worker)
+                continue;
+
+            QMutexLocker locker(&victim->mutex);
+            if (!victim->tasks[index].empty()) {
+                *task = victim->tasks[index].front();
+                victim->tasks[index].pop_front();
+                found = true;
+            }
+        }
+
+        QMutexLocker locker(&m_mutex);
+        if (found) {
+            --m_pendingCounts[index];
+            task->isCounted = isLimited;
+            return true;
+        }
+
+        if (isLimited)
+            --m_backgroundTaskCount;
+    }
+
+    return false;
+}
+
+void SearchScheduler::runTask(Worker *worker, const Task &task)
+{
+    Priority previousPriority = Priority::Interactive;
+    if (worker) {
+        previousPriority = worker->priority;
+        worker->priority = task.priority;
+    }
+
+    task.function();
+
+    if (worker)
+        worker->priority = previousPriority;
+
+    if (task.isCounted) {
+        QMutexLocker locker(&m_mutex);
+        --m_backgroundTaskCount;
+        m_wakeCondition.wakeOne();
+    }
+}
+
+/// Returns true if an idle worker could take a task, must be called with m_mutex locked.
+bool SearchScheduler::hasRunnableTasks() const
+{
+    const int background = static_cast<int>(Priority::Background);
+    for (int index = 0; index < background; ++index) {
+        if (m_pendingCounts[index] > 0)
+            return true;
+    }
+
+    return m_pendingCounts[background] > 0 && m_backgroundTaskCount < m_maxBackgroundTasks;
+}
+
+void SearchScheduler::workerLoop(Worker *worker)
+{
+    Task task;
+    forever {
+        if (takeTask(worker, Priority::Background, true, &task)) {
+            runTask(worker, task);
+            continue;
+        }
+
+        QMutexLocker locker(&m_mutex);
+        while (!hasRunnableTasks()) {
+            if (m_isStopping && m_pendingCounts[static_cast<int>(Priority::Background)] == 0)
+                return;
+            m_wakeCondition.wait(&m_mutex);
+        }
+    }
+}
+
+SearchScheduler::Worker *SearchScheduler::currentWorker() const
+{
+    Worker *worker = dynamic_cast<Worker *>(QThread::currentThread());
+    return worker && worker->scheduler == this ? worker : nullptr;
+}
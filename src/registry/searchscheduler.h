@@ -0,0 +1,156 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 Oleg Shparber
+** Copyright (C) 2013-2014 Jerzy Kozera
+** Contact: http://zealdocs.org/contact.html
+**
+** This file is part of Zeal.
+**
+** Zeal is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** Zeal is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Zeal. If not, see <http://www.gnu.org/licenses/>.
+**
+****************************************************************************/
+
+#ifndef SEARCHSCHEDULER_H
+#define SEARCHSCHEDULER_H
+
+#include <deque>
+#include <functional>
+#include <QFuture>
+#include <QFutureInterface>
+#include <QMutex>
+#include <QVector>
+#include <QWaitCondition>
+
+namespace Zeal {
+
+/**
+ * @brief The SearchScheduler class
+ * A dedicated thread pool for search tasks, separate from the global QThreadPool.
+ *
+ * Tasks have a priority and higher priority tasks always start first. Tasks
+ * scheduled from a worker go to its own deque and are taken newest first,
+ * idle workers steal the oldest tasks of other workers. Only a few workers run
+ * background tasks at once, so that long jobs cannot delay interactive search.
+ *
+ * shutdown() must be called before objects used by tasks are destroyed, since
+ * the scheduler itself is a static that outlives them.
+ */
+class SearchScheduler
+{
+public:
+    enum class Priority {
+        Interactive, ///< The current query
+        Prefetch,    ///< Speculative searches
+        Background   ///< Indexing and other long jobs
+    };
+
+    explicit SearchScheduler(int workerCount);
+    ~SearchScheduler();
+
+    static SearchScheduler *instance();
+
+    int workerCount() const;
+
+    /**
+     * @brief shutdown
+     * Cancels queued background tasks, lets other tasks finish and joins the
+     * workers. Later background tasks are cancelled, other tasks run on the
+     * calling thread.
+     */
+    void shutdown();
+
+    /// Runs \a function on a worker, the returned future reports its result.
+    template<typename Function>
+    auto run(Priority priority, Function function) -> QFuture<decltype(function())>;
+
+    /**
+     * @brief runAll
+     * Runs all \a functions and returns once they are finished. Tasks inherit
+     * priority of the calling task. The calling thread runs the first function
+     * and then helps with other tasks, so nested calls cannot exhaust workers.
+     */
+    void runAll(const QVector<std::function<void()>> &functions);
+
+private:
+    Q_DISABLE_COPY(SearchScheduler)
+
+    class Worker;
+
+    struct Task {
+        std::function<void()> function;
+        std::function<void()> cancel; // Finishes the future of a dropped task, empty for subtasks
+        Priority priority;
+        bool isCounted; // Taken into m_backgroundTaskCount
+    };
+
+    template<typename T>
+    struct ResultReporter {
+        template<typename Function>
+        static void run(QFutureInterface<T> &futureInterface, Function &function)
+        {
+            futureInterface.reportResult(function());
+        }
+    };
+
+    void schedule(Priority priority, const std::function<void()> &function,
+                  const std::function<void()> &cancel = std::function<void()>());
+    bool isDropped(const Task &task) const;
+    bool takeTask(Worker *worker, Priority maxPriority, bool limitBackground, Task *task);
+    void runTask(Worker *worker, const Task &task);
+    bool hasRunnableTasks() const;
+    void workerLoop(Worker *worker);
+    Worker *currentWorker() const;
+
+    QVector<Worker *> m_workers;
+    int m_maxBackgroundTasks;
+
+    // Guards the shared queues, counters and the stopping flag, locked before a worker mutex
+    mutable QMutex m_mutex;
+    QWaitCondition m_wakeCondition;
+    std::deque<Task> m_tasks[3]; // Tasks scheduled from other threads, per priority
+    int m_pendingCounts[3] = {0, 0, 0};
+    int m_backgroundTaskCount = 0;
+    bool m_isStopping = false;
+};
+
+template<>
+struct SearchScheduler::ResultReporter<void> {
+    template<typename Function>
+    static void run(QFutureInterface<void> &futureInterface, Function &function)
+    {
+        Q_UNUSED(futureInterface)
+        function();
+    }
+};
+
+template<typename Function>
+auto SearchScheduler::run(Priority priority, Function function) -> QFuture<decltype(function())>
+{
+    typedef decltype(function()) Result;
+
+    QFutureInterface<Result> futureInterface;
+    futureInterface.reportStarted();
+    schedule(priority, [futureInterface, function]() mutable {
+        ResultReporter<Result>::run(futureInterface, function);
+        futureInterface.reportFinished();
+    }, [futureInterface]() mutable {
+        futureInterface.reportCanceled();
+        futureInterface.reportFinished();
+    });
+    return futureInterface.future();
+}
+
+} // namespace Zeal
+
+#endif // SEARCHSCHEDULER_H
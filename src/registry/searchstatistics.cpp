@@ -0,0 +1,231 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 Oleg Shparber
+** Copyright (C) 2013-2014 Jerzy Kozera
+** Contact: http://zealdocs.org/contact.html
+**
+** This file is part of Zeal.
+**
+** Zeal is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** Zeal is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Zeal. If not, see <http://www.gnu.org/licenses/>.
+**
+****************************************************************************/
+
+#include "searchstatistics.h"
+
+#include "prefixcache.h"
+#include "toccache.h"
+
+#include <QJsonArray>
+
+using namespace Zeal;
+
+namespace {
+// Enough buckets for any quint64 value
+const int BucketCount = 64 * 8;
+}
+
+LatencyHistogram::LatencyHistogram() :
+    m_buckets(BucketCount, 0)
+{
+}
+
+void LatencyHistogram::record(qint64 nanoseconds)
+{
+    const quint64 microseconds = static_cast<quint64>(qMax(Q_INT64_C(0), nanoseconds)) / 1000;
+    ++m_buckets[bucketIndex(microseconds)];
+    ++m_count;
+    m_totalMicroseconds += microseconds;
+    m_maxMicroseconds = qMax(m_maxMicroseconds, static_cast<qint64>(microseconds));
+}
+
+qint64 LatencyHistogram::count() const
+{
+    return m_count;
+}
+
+qint64 LatencyHistogram::percentile(double percentile) const
+{
+    if (m_count == 0)
+        return 0;
+
+    const qint64 rank = qMax(Q_INT64_C(1), static_cast<qint64>(m_count * percentile / 100 + 0.5));
+    qint64 seen = 0;
+    for (int i = 0; i < m_buckets.size(); ++i) {
+        seen += m_buckets.at(i);
+        if (seen >= rank)
+            return qMin(static_cast<qint64>(bucketUpperBound(i)), m_maxMicroseconds);
+    }
+
+    return m_maxMicroseconds;
+}
+
+QJsonObject LatencyHistogram::toJson() const
+{
+    // Only non-empty buckets, as [upper bound in microseconds, count] pairs
+    QJsonArray buckets;
+    for (int i = 0; i < m_buckets.size(); ++i) {
+        if (m_buckets.at(i) == 0)
+            continue;
+
+        QJsonArray bucket;
+        bucket.append(static_cast<double>(bucketUpperBound(i)));
+        bucket.append(static_cast<double>(m_buckets.at(i)));
+        buckets.append(bucket);
+    }
+
+    QJsonObject object;
+    object[QStringLiteral("count")] = static_cast<double>(m_count);
+    object[QStringLiteral("mean_us")] = m_count ? static_cast<double>(m_totalMicroseconds) / m_count : 0.0;
+    object[QStringLiteral("p50_us")] = static_cast<double>(percentile(50));
+    object[QStringLiteral("p90_us")] = static_cast<double>(percentile(90));
+    object[QStringLiteral("p99_us")] = static_cast<double>(percentile(99));
+    object[QStringLiteral("max_us")] = static_cast<double>(m_maxMicroseconds);
+    object[QStringLiteral("buckets")] = buckets;
+    return object;
+}
+
+int LatencyHistogram::bucketIndex(quint64 microseconds)
+{
+    if (microseconds < SubBucketCount)
+        return static_cast<int>(microseconds);
+
+    int exponent = 0;
+    while ((microseconds >> exponent) > 1)
+        ++exponent;
+
+    const int shift = exponent - SubBucketBits;
+    const int subBucket = static_cast<int>((microseconds >> shift) & (SubBucketCount - 1));
+    return (shift + 1) * SubBucketCount + subBucket;
+}
+
+quint64 LatencyHistogram::bucketUpperBound(int index)
+{
+    if (index < SubBucketCount)
+        return static_cast<quint64>(index);
+
+    const int shift = index / SubBucketCount - 1;
+    const quint64 lowerBound = static_cast<quint64>(SubBucketCount + index % SubBucketCount) << shift;
+    return lowerBound + (Q_UINT64_C(1) << shift) - 1;
+}
+
+SearchStatistics::Timer::Timer(Stage stage, const QString &docsetName) :
+    m_stage(stage),
+    m_docsetName(docsetName)
+{
+    m_timer.start();
+}
+
+SearchStatistics::Timer::~Timer()
+{
+    const qint64 elapsed = m_timer.nsecsElapsed();
+    SearchStatistics::instance()->record(m_stage, elapsed);
+    if (!m_docsetName.isEmpty())
+        SearchStatistics::instance()->recordDocset(m_docsetName, elapsed);
+}
+
+SearchStatistics *SearchStatistics::instance()
+{
+    static SearchStatistics statistics;
+    return &statistics;
+}
+
+void SearchStatistics::record(Stage stage, qint64 nanoseconds)
+{
+    QMutexLocker locker(&m_mutex);
+    m_stages[static_cast<int>(stage)].record(nanoseconds);
+}
+
+void SearchStatistics::recordDocset(const QString &docsetName, qint64 nanoseconds)
+{
+    QMutexLocker locker(&m_mutex);
+    m_docsets[docsetName].record(nanoseconds);
+}
+
+void SearchStatistics::recordCacheLookup(bool isHit)
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_cacheLookups;
+    if (isHit)
+        ++m_cacheHits;
+}
+
+void SearchStatistics::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    for (LatencyHistogram &histogram : m_stages)
+        histogram = LatencyHistogram();
+    m_docsets.clear();
+    m_cacheLookups = 0;
+    m_cacheHits = 0;
+}
+
+QJsonObject SearchStatistics::toJson() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QJsonObject stages;
+    for (int i = 0; i < StageCount; ++i)
+        stages[stageName(static_cast<Stage>(i))] = m_stages[i].toJson();
+
+    QJsonObject docsets;
+    for (auto it = m_docsets.cbegin(); it != m_docsets.cend(); ++it)
+        docsets[it.key()] = it.value().toJson();
+
+    const PrefixCache *prefixCache = PrefixCache::instance();
+    QJsonObject cache;
+    cache[QStringLiteral("lookups")] = static_cast<double>(m_cacheLookups);
+    cache[QStringLiteral("hits")] = static_cast<double>(m_cacheHits);
+    cache[QStringLiteral("hit_rate")] = m_cacheLookups
+            ? static_cast<double>(m_cacheHits) / m_cacheLookups : 0.0;
+    cache[QStringLiteral("size_bytes")] = static_cast<double>(prefixCache->size());
+    cache[QStringLiteral("budget_bytes")] = static_cast<double>(prefixCache->budget());
+
+    const TocCache *tocCache = TocCache::instance();
+    QJsonObject toc;
+    toc[QStringLiteral("size_bytes")] = static_cast<double>(tocCache->size());
+    toc[QStringLiteral("budget_bytes")] = static_cast<double>(tocCache->budget());
+
+    QJsonObject object;
+    object[QStringLiteral("stages")] = stages;
+    object[QStringLiteral("docsets")] = docsets;
+    object[QStringLiteral("prefix_cache")] = cache;
+    object[QStringLiteral("toc_cache")] = toc;
+    return object;
+}
+
+QString SearchStatistics::stageName(Stage stage)
+{
+    switch (stage) {
+    case Stage::Query:
+        return QStringLiteral("query");
+    case Stage::CancelledQuery:
+        return QStringLiteral("cancelled_query");
+    case Stage::Parse:
+        return QStringLiteral("parse");
+    case Stage::Docset:
+        return QStringLiteral("docset");
+    case Stage::IndexMatch:
+        return QStringLiteral("index_match");
+    case Stage::Scoring:
+        return QStringLiteral("scoring");
+    case Stage::Sql:
+        return QStringLiteral("sql");
+    case Stage::Merge:
+        return QStringLiteral("merge");
+    case Stage::Model:
+        return QStringLiteral("model");
+    }
+
+    return QString();
+}
@@ -0,0 +1,131 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 Oleg Shparber
+** Copyright (C) 2013-2014 Jerzy Kozera
+** Contact: http://zealdocs.org/contact.html
+**
+** This file is part of Zeal.
+**
+** Zeal is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** Zeal is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Zeal. If not, see <http://www.gnu.org/licenses/>.
+**
+****************************************************************************/
+
+#ifndef SEARCHSTATISTICS_H
+#define SEARCHSTATISTICS_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+namespace Zeal {
+
+/**
+ * @brief The LatencyHistogram class
+ * A log-linear histogram of latencies in microseconds.
+ *
+ * Every power of two is split into SubBucketCount buckets, so a recorded
+ * value is reported with an error of at most 1/SubBucketCount, regardless of
+ * its magnitude.
+ */
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    void record(qint64 nanoseconds);
+
+    qint64 count() const;
+    /// Returns the value in microseconds below which \a percentile percent of values fall.
+    qint64 percentile(double percentile) const;
+    QJsonObject toJson() const;
+
+private:
+    static const int SubBucketBits = 3;
+    static const int SubBucketCount = 1 << SubBucketBits;
+
+    static int bucketIndex(quint64 microseconds);
+    static quint64 bucketUpperBound(int index);
+
+    QVector<quint64> m_buckets;
+    qint64 m_count = 0;
+    qint64 m_totalMicroseconds = 0;
+    qint64 m_maxMicroseconds = 0;
+};
+
+/**
+ * @brief The SearchStatistics class
+ * Collects latencies of search stages and docsets, and prefix cache hit rates.
+ */
+class SearchStatistics
+{
+public:
+    enum class Stage {
+        Query,          ///< From dispatch until all docsets are searched
+        CancelledQuery, ///< Same as Query, for queries superseded before completion
+        Parse,          ///< Parsing of the query string
+        Docset,         ///< Search of a single docset
+        IndexMatch,     ///< Symbol index lookups
+        Scoring,        ///< Scoring and selection of results
+        Sql,            ///< SQLite queries of docsets without a symbol index
+        Merge,          ///< Merging of docset results
+        Model           ///< Updates of the search model
+    };
+
+    /**
+     * @brief The Timer class
+     * Records time between its construction and destruction.
+     */
+    class Timer
+    {
+    public:
+        explicit Timer(Stage stage, const QString &docsetName = QString());
+        ~Timer();
+
+    private:
+        Q_DISABLE_COPY(Timer)
+
+        Stage m_stage;
+        QString m_docsetName;
+        QElapsedTimer m_timer;
+    };
+
+    static SearchStatistics *instance();
+
+    void record(Stage stage, qint64 nanoseconds);
+    void recordDocset(const QString &docsetName, qint64 nanoseconds);
+    void recordCacheLookup(bool isHit);
+
+    void reset();
+
+    /// Returns all statistics in a machine-readable form.
+    QJsonObject toJson() const;
+
+    static QString stageName(Stage stage);
+
+private:
+    static const int StageCount = 9;
+
+    mutable QMutex m_mutex;
+    LatencyHistogram m_stages[StageCount];
+    QHash<QString, LatencyHistogram> m_docsets;
+    qint64 m_cacheLookups = 0;
+    qint64 m_cacheHits = 0;
+};
+
+} // namespace Zeal
+
+#endif // SEARCHSTATISTICS_H
@@ -0,0 +1,61 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 Oleg Shparber
+** Copyright (C) 2013-2014 Jerzy Kozera
+** Contact: http://zealdocs.org/contact.html
+**
+** This file is part of Zeal.
+**
+** Zeal is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** Zeal is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Zeal. If not, see <http://www.gnu.org/licenses/>.
+**
+****************************************************************************/
+
+#include "sqliteinterrupter.h"
+
+#include <QSqlDatabase>
+#include <QSqlDriver>
+#include <QVariant>
+
+#ifdef USE_SQLITE_INTERRUPT
+#include <sqlite3.h>
+#endif
+
+using namespace Zeal;
+
+SqliteInterrupter::SqliteInterrupter(const QSqlDatabase &db, const CancellationToken &token) :
+    m_token(token)
+{
+#ifdef USE_SQLITE_INTERRUPT
+    const QVariant handle = db.driver()->handle();
+    if (!handle.isValid() || qstrcmp(handle.typeName(), "sqlite3*") != 0)
+        return;
+
+    m_handle = *static_cast<sqlite3 * const *>(handle.data());
+    if (!m_handle)
+        return;
+
+    sqlite3 *connection = m_handle;
+    m_callbackId = m_token.registerCallback([connection]() {
+        sqlite3_interrupt(connection);
+    });
+#else
+    Q_UNUSED(db)
+#endif
+}
+
+SqliteInterrupter::~SqliteInterrupter()
+{
+    if (m_callbackId != -1)
+        m_token.unregisterCallback(m_callbackId);
+}
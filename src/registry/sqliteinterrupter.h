@@ -0,0 +1,67 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 Oleg Shparber
+** Copyright (C) 2013-2014 Jerzy Kozera
+** Contact: http://zealdocs.org/contact.html
+**
+** This file is part of Zeal.
+**
+** Zeal is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** Zeal is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Zeal. If not, see <http://www.gnu.org/licenses/>.
+**
+****************************************************************************/
+
+#ifndef SQLITEINTERRUPTER_H
+#define SQLITEINTERRUPTER_H
+
+#include "cancellationtoken.h"
+
+class QSqlDatabase;
+
+struct sqlite3;
+
+namespace Zeal {
+
+/**
+ * @brief The SqliteInterrupter class
+ * Aborts statements running on an SQLite connection once a token is cancelled.
+ *
+ * While an instance exists, cancelling the token calls sqlite3_interrupt() on
+ * the connection, so even a long scan or sort stops as soon as the search is
+ * superseded. The interrupted query then fails as if it found no rows.
+ *
+ * sqlite3_interrupt() aborts every statement running on the connection, so
+ * the connection must not be shared with other threads. Docset::database()
+ * returns a connection of the calling thread.
+ *
+ * Requires Zeal to be built with CONFIG+=sqlite_interrupt against the same
+ * SQLite library as the Qt SQLite plugin. Otherwise this does nothing, and
+ * callers still have to check the token between rows.
+ */
+class SqliteInterrupter
+{
+public:
+    SqliteInterrupter(const QSqlDatabase &db, const CancellationToken &token);
+    ~SqliteInterrupter();
+
+private:
+    Q_DISABLE_COPY(SqliteInterrupter)
+
+    sqlite3 *m_handle = nullptr;
+    CancellationToken m_token;
+    int m_callbackId = -1;
+};
+
+} // namespace Zeal
+
+#endif // SQLITEINTERRUPTER_H
@@ -0,0 +1,139 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 Oleg Shparber
+** Copyright (C) 2013-2014 Jerzy Kozera
+** Contact: http://zealdocs.org/contact.html
+**
+** This file is part of Zeal.
+**
+** Zeal is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** Zeal is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Zeal. If not, see <http://www.gnu.org/licenses/>.
+**
+****************************************************************************/
+
+#include "substringmatcher.h"
+
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ZEAL_MATCHER_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace Zeal;
+
+namespace {
+inline int countTrailingZeroBits(quint32 value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return index;
+#else
+    return __builtin_ctz(value);
+#endif
+}
+}
+
+SubstringMatcher::SubstringMatcher(const QString &foldedNeedle) :
+    m_needle(foldedNeedle),
+    m_data(m_needle.utf16()),
+    m_size(m_needle.size())
+{
+}
+
+int SubstringMatcher::size() const
+{
+    return m_size;
+}
+
+int SubstringMatcher::indexIn(const QString &foldedHaystack) const
+{
+    return indexIn(foldedHaystack.utf16(), foldedHaystack.size());
+}
+
+int SubstringMatcher::indexIn(const ushort *haystack, int haystackSize) const
+{
+    if (m_size == 0)
+        return 0;
+    if (m_size > haystackSize)
+        return -1;
+
+    int i = 0;
+
+#if defined(__AVX2__) || defined(ZEAL_MATCHER_SSE2)
+#ifdef __AVX2__
+    typedef __m256i Block;
+    const int BlockSize = 16;
+    const Block first = _mm256_set1_epi16(static_cast<short>(m_data[0]));
+    const Block last = _mm256_set1_epi16(static_cast<short>(m_data[m_size - 1]));
+#else
+    typedef __m128i Block;
+    const int BlockSize = 8;
+    const Block first = _mm_set1_epi16(static_cast<short>(m_data[0]));
+    const Block last = _mm_set1_epi16(static_cast<short>(m_data[m_size - 1]));
+#endif
+
+    // Each block checks candidates starting at i..i + BlockSize - 1
+    for (; i + m_size - 1 + BlockSize <= haystackSize; i += BlockSize) {
+#ifdef __AVX2__
+        const Block blockFirst = _mm256_loadu_si256(reinterpret_cast<const Block *>(haystack + i));
+        const Block blockLast = _mm256_loadu_si256(
+                    reinterpret_cast<const Block *>(haystack + i + m_size - 1));
+        const Block eq = _mm256_and_si256(_mm256_cmpeq_epi16(first, blockFirst),
+                                          _mm256_cmpeq_epi16(last, blockLast));
+        quint32 mask = static_cast<quint32>(_mm256_movemask_epi8(eq));
+#else
+        const Block blockFirst = _mm_loadu_si128(reinterpret_cast<const Block *>(haystack + i));
+        const Block blockLast = _mm_loadu_si128(
+                    reinterpret_cast<const Block *>(haystack + i + m_size - 1));
+        const Block eq = _mm_and_si128(_mm_cmpeq_epi16(first, blockFirst),
+                                       _mm_cmpeq_epi16(last, blockLast));
+        quint32 mask = static_cast<quint32>(_mm_movemask_epi8(eq));
+#endif
+
+        // Every 16-bit lane sets two mask bits
+        while (mask) {
+            const int lane = countTrailingZeroBits(mask) / 2;
+            if (matchesAt(haystack + i + lane))
+                return i + lane;
+            mask &= ~(quint32(3) << (lane * 2));
+        }
+    }
+#endif
+
+    return scalarIndexIn(haystack, haystackSize, i);
+}
+
+int SubstringMatcher::scalarIndexIn(const ushort *haystack, int haystackSize, int from) const
+{
+    const ushort first = m_data[0];
+    const ushort last = m_data[m_size - 1];
+    for (int i = from; i + m_size <= haystackSize; ++i) {
+        if (haystack[i] == first && haystack[i + m_size - 1] == last && matchesAt(haystack + i))
+            return i;
+    }
+    return -1;
+}
+
+bool SubstringMatcher::matchesAt(const ushort *str) const
+{
+    // First and last characters are already known to match
+    return m_size <= 2 || std::equal(m_data + 1, m_data + m_size - 1, str + 1);
+}
@@ -0,0 +1,62 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 Oleg Shparber
+** Copyright (C) 2013-2014 Jerzy Kozera
+** Contact: http://zealdocs.org/contact.html
+**
+** This file is part of Zeal.
+**
+** Zeal is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** Zeal is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Zeal. If not, see <http://www.gnu.org/licenses/>.
+**
+****************************************************************************/
+
+#ifndef SUBSTRINGMATCHER_H
+#define SUBSTRINGMATCHER_H
+
+#include <QString>
+
+namespace Zeal {
+
+/**
+ * @brief The SubstringMatcher class
+ * Finds a case folded needle in contiguous case folded UTF-16 storage.
+ *
+ * Candidate positions are found by comparing the first and the last
+ * character of the needle against whole blocks of the haystack with SSE2 or
+ * AVX2, and only those candidates are compared in full. A scalar loop is
+ * used on other architectures and for the tail of the haystack.
+ */
+class SubstringMatcher
+{
+public:
+    explicit SubstringMatcher(const QString &foldedNeedle);
+
+    int size() const;
+
+    /// Returns position of the needle in \a haystack or -1.
+    int indexIn(const ushort *haystack, int haystackSize) const;
+    int indexIn(const QString &foldedHaystack) const;
+
+private:
+    int scalarIndexIn(const ushort *haystack, int haystackSize, int from) const;
+    bool matchesAt(const ushort *str) const;
+
+    QString m_needle;
+    const ushort *m_data;
+    int m_size;
+};
+
+} // namespace Zeal
+
+#endif // SUBSTRINGMATCHER_H
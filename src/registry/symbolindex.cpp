@@ -0,0 +1,682 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 Oleg Shparber
+** Copyright (C) 2013-2014 Jerzy Kozera
+** Contact: http://zealdocs.org/contact.html
+**
+** This file is part of Zeal.
+**
+** Zeal is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** Zeal is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Zeal. If not, see <http://www.gnu.org/licenses/>.
+**
+****************************************************************************/
+
+#include "symbolindex.h"
+
+#include "substringmatcher.h"
+
+#include <algorithm>
+#include <cstring>
+#include <QFile>
+#include <QHash>
+#include <QSaveFile>
+
+using namespace Zeal;
+
+namespace {
+const quint32 IndexMagic = 0x5844495a; // "ZIDX"
+const quint32 IndexFormatVersion = 3;
+
+const int GramSize = 3;
+const int GramBucketCount = 1 << 16;
+
+// How often long loops poll the cancellation token.
+const int CancellationCheckInterval = 1024;
+
+inline quint32 gramBucket(const ushort *str)
+{
+    quint32 hash = str[0] * 0x9e3779b1u;
+    hash ^= str[1] * 0x85ebca77u;
+    hash ^= str[2] * 0xc2b2ae3du;
+    return hash >> 16;
+}
+
+inline quint32 alignedOffset(quint32 offset)
+{
+    return (offset + 7) & ~7u;
+}
+
+// Characters are hashed into 64 bits, with a bit of its own for every ASCII letter and digit.
+inline quint64 charBit(ushort ch)
+{
+    if (ch >= 'a' && ch <= 'z')
+        return quint64(1) << (ch - 'a');
+    if (ch >= '0' && ch <= '9')
+        return quint64(1) << (26 + ch - '0');
+    return quint64(1) << (36 + ch % 28);
+}
+
+// Returns positions right after each ".", "::" and "/" in a name, matched left to right.
+QVector<quint16> separatorEnds(const QString &name)
+{
+    QVector<quint16> ends;
+    for (int i = 0; i < name.size(); ++i) {
+        const QChar ch = name.at(i);
+        if (ch == QLatin1Char('.') || ch == QLatin1Char('/')) {
+            ends.append(i + 1);
+        } else if (ch == QLatin1Char(':') && i + 1 < name.size() && name.at(i + 1) == QLatin1Char(':')) {
+            ends.append(i + 2);
+            ++i;
+        }
+    }
+    return ends;
+}
+
+// Returns sorted unique gram buckets of a case folded name.
+QVector<quint32> gramBuckets(const QString &foldedName)
+{
+    QVector<quint32> buckets;
+    const ushort *str = foldedName.utf16();
+    for (int i = 0; i + GramSize <= foldedName.size(); ++i)
+        buckets.append(gramBucket(str + i));
+
+    std::sort(buckets.begin(), buckets.end());
+    buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+    return buckets;
+}
+}
+
+namespace Zeal {
+
+struct SymbolIndex::Header
+{
+    quint32 magic;
+    quint32 formatVersion;
+    quint32 symbolCount;
+    quint32 typeCount;
+
+    // Byte offsets of the sections, sizes are in elements
+    quint32 entriesOffset;      // Entry[symbolCount]
+    quint32 namesOffset;        // ushort[nameArenaSize]
+    quint32 foldedNamesOffset;  // ushort[nameArenaSize], names are separated with '\0'
+    quint32 nameArenaSize;
+    quint32 pathsOffset;        // ushort[pathArenaSize]
+    quint32 pathArenaSize;
+    quint32 separatorsOffset;   // quint16[separatorCount], see separatorEnds()
+    quint32 separatorCount;
+    quint32 charMasksOffset;    // quint64[symbolCount], see charMask()
+    quint32 typesOffset;        // quint32[typeCount + 1], offsets into the type arena
+    quint32 typeArenaOffset;    // ushort[]
+    quint32 gramTableOffset;    // quint32[GramBucketCount + 1], offsets into postings
+    quint32 postingsOffset;     // quint32[postingCount]
+    quint32 postingCount;
+    quint32 keyOffset;          // ushort[keyLength]
+    quint32 keyLength;
+};
+
+struct SymbolIndex::Entry
+{
+    quint32 nameOffset;
+    quint16 nameLength;
+    quint16 typeId;
+    quint32 pathOffset;
+    quint32 pathLength;
+    quint32 separatorOffset;
+    quint16 separatorCount;
+    quint16 reserved;
+};
+
+} // namespace Zeal
+
+void SymbolIndex::Builder::addSymbol(const QString &name, const QString &type, const QString &path)
+{
+    // Longer names do not fit into an entry and are not useful for search anyway
+    if (name.isEmpty() || name.size() > 0xffff)
+        return;
+
+    m_symbols.append(Symbol{name, foldCase(name), type, path, separatorEnds(name)});
+}
+
+std::unique_ptr<SymbolIndex> SymbolIndex::Builder::build(const QString &key)
+{
+    std::sort(m_symbols.begin(), m_symbols.end(), [](const Symbol &lhs, const Symbol &rhs) {
+        if (lhs.foldedName != rhs.foldedName)
+            return lhs.foldedName < rhs.foldedName;
+        return lhs.name < rhs.name;
+    });
+
+    // Intern types and measure arenas
+    QHash<QString, int> typeIds;
+    QStringList types;
+    quint32 nameArenaSize = 0;
+    quint32 pathArenaSize = 0;
+    quint32 separatorCount = 0;
+    quint32 typeArenaSize = 0;
+
+    QVector<quint32> gramCounts(GramBucketCount + 1, 0);
+    quint32 postingCount = 0;
+
+    for (const Symbol &symbol : m_symbols) {
+        if (!typeIds.contains(symbol.type)) {
+            typeIds.insert(symbol.type, types.size());
+            types.append(symbol.type);
+            typeArenaSize += symbol.type.size();
+        }
+
+        nameArenaSize += symbol.name.size() + 1;
+        pathArenaSize += symbol.path.size();
+        separatorCount += symbol.separatorEnds.size();
+
+        for (quint32 bucket : gramBuckets(symbol.foldedName)) {
+            ++gramCounts[bucket + 1];
+            ++postingCount;
+        }
+    }
+
+    if (types.size() > 0xffff)
+        return nullptr;
+
+    // Lay out sections
+    Header header = {};
+    header.magic = IndexMagic;
+    header.formatVersion = IndexFormatVersion;
+    header.symbolCount = m_symbols.size();
+    header.typeCount = types.size();
+    header.nameArenaSize = nameArenaSize;
+    header.pathArenaSize = pathArenaSize;
+    header.separatorCount = separatorCount;
+    header.postingCount = postingCount;
+    header.keyLength = key.size();
+
+    quint32 size = alignedOffset(sizeof(Header));
+    header.entriesOffset = size;
+    size = alignedOffset(size + header.symbolCount * sizeof(Entry));
+    header.namesOffset = size;
+    size = alignedOffset(size + nameArenaSize * sizeof(ushort));
+    header.foldedNamesOffset = size;
+    size = alignedOffset(size + nameArenaSize * sizeof(ushort));
+    header.pathsOffset = size;
+    size = alignedOffset(size + pathArenaSize * sizeof(ushort));
+    header.separatorsOffset = size;
+    size = alignedOffset(size + separatorCount * sizeof(quint16));
+    header.charMasksOffset = size;
+    size = alignedOffset(size + header.symbolCount * sizeof(quint64));
+    header.typesOffset = size;
+    size = alignedOffset(size + (header.typeCount + 1) * sizeof(quint32));
+    header.typeArenaOffset = size;
+    size = alignedOffset(size + typeArenaSize * sizeof(ushort));
+    header.gramTableOffset = size;
+    size = alignedOffset(size + (GramBucketCount + 1) * sizeof(quint32));
+    header.postingsOffset = size;
+    size = alignedOffset(size + postingCount * sizeof(quint32));
+    header.keyOffset = size;
+    size = alignedOffset(size + header.keyLength * sizeof(ushort));
+
+    QByteArray data(size, Qt::Uninitialized);
+    uchar *base = reinterpret_cast<uchar *>(data.data());
+    memset(base, 0, size);
+    memcpy(base, &header, sizeof(Header));
+
+    Entry *entries = reinterpret_cast<Entry *>(base + header.entriesOffset);
+    ushort *names = reinterpret_cast<ushort *>(base + header.namesOffset);
+    ushort *foldedNames = reinterpret_cast<ushort *>(base + header.foldedNamesOffset);
+    ushort *paths = reinterpret_cast<ushort *>(base + header.pathsOffset);
+    quint16 *separators = reinterpret_cast<quint16 *>(base + header.separatorsOffset);
+    quint64 *charMasks = reinterpret_cast<quint64 *>(base + header.charMasksOffset);
+    quint32 *typeOffsets = reinterpret_cast<quint32 *>(base + header.typesOffset);
+    ushort *typeArena = reinterpret_cast<ushort *>(base + header.typeArenaOffset);
+    quint32 *gramTable = reinterpret_cast<quint32 *>(base + header.gramTableOffset);
+    quint32 *postings = reinterpret_cast<quint32 *>(base + header.postingsOffset);
+
+    memcpy(base + header.keyOffset, key.utf16(), key.size() * sizeof(ushort));
+
+    quint32 typeOffset = 0;
+    for (int i = 0; i < types.size(); ++i) {
+        typeOffsets[i] = typeOffset;
+        memcpy(typeArena + typeOffset, types.at(i).utf16(), types.at(i).size() * sizeof(ushort));
+        typeOffset += types.at(i).size();
+    }
+    typeOffsets[types.size()] = typeOffset;
+
+    for (int i = 0; i < GramBucketCount; ++i)
+        gramCounts[i + 1] += gramCounts[i];
+    memcpy(gramTable, gramCounts.constData(), (GramBucketCount + 1) * sizeof(quint32));
+
+    quint32 nameOffset = 0;
+    quint32 pathOffset = 0;
+    quint32 separatorOffset = 0;
+    for (int id = 0; id < m_symbols.size(); ++id) {
+        const Symbol &symbol = m_symbols.at(id);
+
+        Entry &entry = entries[id];
+        entry.nameOffset = nameOffset;
+        entry.nameLength = symbol.name.size();
+        entry.typeId = typeIds.value(symbol.type);
+        entry.pathOffset = pathOffset;
+        entry.pathLength = symbol.path.size();
+        entry.separatorOffset = separatorOffset;
+        entry.separatorCount = symbol.separatorEnds.size();
+
+        memcpy(names + nameOffset, symbol.name.utf16(), symbol.name.size() * sizeof(ushort));
+        memcpy(foldedNames + nameOffset, symbol.foldedName.utf16(),
+               symbol.foldedName.size() * sizeof(ushort));
+        nameOffset += symbol.name.size() + 1;
+
+        memcpy(paths + pathOffset, symbol.path.utf16(), symbol.path.size() * sizeof(ushort));
+        pathOffset += symbol.path.size();
+
+        charMasks[id] = charMask(symbol.foldedName);
+
+        std::copy(symbol.separatorEnds.cbegin(), symbol.separatorEnds.cend(), separators + separatorOffset);
+        separatorOffset += symbol.separatorEnds.size();
+
+        // Ids are appended in ascending order, so posting lists stay sorted
+        for (quint32 bucket : gramBuckets(symbol.foldedName))
+            postings[gramCounts[bucket]++] = id;
+    }
+
+    m_symbols.clear();
+
+    return std::unique_ptr<SymbolIndex>(new SymbolIndex(data));
+}
+
+SymbolIndex::SymbolIndex(const QByteArray &data) :
+    m_data(data),
+    m_base(reinterpret_cast<const uchar *>(m_data.constData()))
+{
+    loadTypes();
+}
+
+SymbolIndex::SymbolIndex(std::unique_ptr<QFile> file, const uchar *base) :
+    m_file(std::move(file)),
+    m_base(base)
+{
+    loadTypes();
+}
+
+SymbolIndex::~SymbolIndex()
+{
+}
+
+std::unique_ptr<SymbolIndex> SymbolIndex::open(const QString &fileName, const QString &key,
+                                               Verification verification)
+{
+    std::unique_ptr<QFile> file(new QFile(fileName));
+    if (!file->open(QIODevice::ReadOnly))
+        return nullptr;
+
+    const qint64 size = file->size();
+    const uchar *base = file->map(0, size);
+    if (!base || !isValidImage(base, size))
+        return nullptr;
+
+    if (verification == Verification::Full && !hasValidEntries(base))
+        return nullptr;
+
+    std::unique_ptr<SymbolIndex> index(new SymbolIndex(std::move(file), base));
+    if (index->key() != key)
+        return nullptr;
+
+    return index;
+}
+
+bool SymbolIndex::save(const QString &fileName) const
+{
+    const Header *h = header();
+    const qint64 size = alignedOffset(h->keyOffset + h->keyLength * sizeof(ushort));
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    if (file.write(reinterpret_cast<const char *>(m_base), size) != size) {
+        file.cancelWriting();
+        return false;
+    }
+
+    return file.commit();
+}
+
+QString SymbolIndex::key() const
+{
+    return QString(reinterpret_cast<const QChar *>(m_base + header()->keyOffset), header()->keyLength);
+}
+
+void SymbolIndex::loadTypes()
+{
+    const quint32 *typeOffsets = reinterpret_cast<const quint32 *>(m_base + header()->typesOffset);
+    const QChar *typeArena = reinterpret_cast<const QChar *>(m_base + header()->typeArenaOffset);
+    for (quint32 i = 0; i < header()->typeCount; ++i)
+        m_types.append(QString(typeArena + typeOffsets[i], typeOffsets[i + 1] - typeOffsets[i]));
+}
+
+int SymbolIndex::symbolCount() const
+{
+    return header()->symbolCount;
+}
+
+QString SymbolIndex::name(int id) const
+{
+    const Entry &e = entry(id);
+    return QString(reinterpret_cast<const QChar *>(names() + e.nameOffset), e.nameLength);
+}
+
+int SymbolIndex::nameLength(int id) const
+{
+    return entry(id).nameLength;
+}
+
+const QChar *SymbolIndex::nameData(int id) const
+{
+    return reinterpret_cast<const QChar *>(names() + entry(id).nameOffset);
+}
+
+const QChar *SymbolIndex::foldedNameData(int id) const
+{
+    return reinterpret_cast<const QChar *>(foldedNames() + entry(id).nameOffset);
+}
+
+quint64 SymbolIndex::charMask(int id) const
+{
+    return reinterpret_cast<const quint64 *>(m_base + header()->charMasksOffset)[id];
+}
+
+QString SymbolIndex::nameRef(int id) const
+{
+    const Entry &e = entry(id);
+    return QString::fromRawData(reinterpret_cast<const QChar *>(names() + e.nameOffset), e.nameLength);
+}
+
+QString SymbolIndex::type(int id) const
+{
+    return m_types.at(entry(id).typeId);
+}
+
+QString SymbolIndex::path(int id) const
+{
+    const Entry &e = entry(id);
+    return QString(reinterpret_cast<const QChar *>(paths() + e.pathOffset), e.pathLength);
+}
+
+int SymbolIndex::separatorCount(int id, int pos) const
+{
+    const Entry &e = entry(id);
+    const quint16 *ends = separators() + e.separatorOffset;
+
+    int count = 0;
+    for (int i = 0; i < e.separatorCount; ++i)
+        count += ends[i] <= pos;
+    return count;
+}
+
+bool SymbolIndex::endsWithSeparator(int id, int pos) const
+{
+    const ushort *name = names() + entry(id).nameOffset;
+    return pos > 0 && (name[pos - 1] == '.' || name[pos - 1] == '/'
+                       || (pos > 1 && name[pos - 2] == ':' && name[pos - 1] == ':'));
+}
+
+int SymbolIndex::indexOf(int id, const QString &foldedQuery) const
+{
+    return indexOf(id, SubstringMatcher(foldedQuery));
+}
+
+int SymbolIndex::indexOf(int id, const SubstringMatcher &matcher) const
+{
+    const Entry &e = entry(id);
+    return matcher.indexIn(foldedNames() + e.nameOffset, e.nameLength);
+}
+
+QVector<int> SymbolIndex::find(const QString &query, int first, int last,
+                               const CancellationToken &token) const
+{
+    QVector<int> ids;
+    const QString foldedQuery = foldCase(query);
+    const SubstringMatcher matcher(foldedQuery);
+    last = std::min(last, symbolCount());
+
+    if (foldedQuery.size() < GramSize) {
+        // Scan the folded name arena in one go, names are separated with '\0' so no match spans two
+        const ushort *arena = foldedNames();
+        const Entry *entries = &entry(0);
+        for (int blockStart = first; blockStart < last; blockStart += CancellationCheckInterval) {
+            if (token.isCancelled())
+                break;
+
+            const int blockEnd = std::min(last, blockStart + CancellationCheckInterval);
+            const quint32 end = blockEnd < symbolCount() ? entries[blockEnd].nameOffset
+                                                         : header()->nameArenaSize;
+            int id = blockStart;
+            while (id < blockEnd) {
+                const quint32 from = entries[id].nameOffset;
+                const int pos = matcher.indexIn(arena + from, end - from);
+                if (pos == -1)
+                    break;
+
+                // Find the name containing the match
+                id = std::upper_bound(entries + id, entries + blockEnd, from + pos,
+                                      [](quint32 offset, const Entry &e) {
+                    return offset < e.nameOffset;
+                }) - entries - 1;
+                ids.append(id++);
+            }
+        }
+        return ids;
+    }
+
+    // Verify only candidates from the shortest posting list
+    const quint32 *it;
+    const quint32 *end;
+    shortestPostingList(foldedQuery, &it, &end);
+    it = std::lower_bound(it, end, static_cast<quint32>(first));
+    for (int i = 0; it != end && *it < static_cast<quint32>(last); ++it, ++i) {
+        if (i % CancellationCheckInterval == 0 && token.isCancelled())
+            break;
+        if (indexOf(*it, matcher) != -1)
+            ids.append(*it);
+    }
+
+    return ids;
+}
+
+QVector<int> SymbolIndex::find(const QString &query, const int *candidates, const int *candidatesEnd,
+                               const CancellationToken &token) const
+{
+    QVector<int> ids;
+    const QString foldedQuery = foldCase(query);
+    const SubstringMatcher matcher(foldedQuery);
+
+    // Intersect sorted candidates with the shortest posting list before verifying them
+    const quint32 *it = nullptr;
+    const quint32 *end = nullptr;
+    if (foldedQuery.size() >= GramSize)
+        shortestPostingList(foldedQuery, &it, &end);
+
+    for (int i = 0; candidates != candidatesEnd; ++candidates, ++i) {
+        if (i % CancellationCheckInterval == 0 && token.isCancelled())
+            break;
+
+        const int id = *candidates;
+        if (it) {
+            it = std::lower_bound(it, end, static_cast<quint32>(id));
+            if (it == end)
+                break;
+            if (*it != static_cast<quint32>(id))
+                continue;
+        }
+
+        if (indexOf(id, matcher) != -1)
+            ids.append(id);
+    }
+
+    return ids;
+}
+
+void SymbolIndex::shortestPostingList(const QString &foldedQuery, const quint32 **begin,
+                                      const quint32 **end) const
+{
+    const quint32 *table = gramTable();
+    const ushort *str = foldedQuery.utf16();
+    quint32 bucket = gramBucket(str);
+    for (int i = 1; i + GramSize <= foldedQuery.size(); ++i) {
+        const quint32 candidate = gramBucket(str + i);
+        if (table[candidate + 1] - table[candidate] < table[bucket + 1] - table[bucket])
+            bucket = candidate;
+    }
+
+    // Bounds of a list are checked when it is used, rather than for every list on open()
+    const quint32 first = table[bucket];
+    const quint32 last = table[bucket + 1];
+    if (first > last || last > header()->postingCount) {
+        *begin = *end = postings();
+        return;
+    }
+
+    *begin = postings() + first;
+    *end = postings() + last;
+}
+
+QString SymbolIndex::foldCase(const QString &str)
+{
+    // Fold per code unit, so that positions in folded names match the original ones
+    QString folded(str);
+    QChar *data = folded.data();
+    for (int i = 0; i < folded.size(); ++i)
+        data[i] = data[i].toCaseFolded();
+    return folded;
+}
+
+quint64 SymbolIndex::charMask(const QString &foldedStr)
+{
+    quint64 mask = 0;
+    for (int i = 0; i < foldedStr.size(); ++i)
+        mask |= charBit(foldedStr.at(i).unicode());
+    return mask;
+}
+
+bool SymbolIndex::isValidImage(const uchar *base, qint64 size)
+{
+    if (size < static_cast<qint64>(sizeof(Header)))
+        return false;
+
+    const Header *h = reinterpret_cast<const Header *>(base);
+    if (h->magic != IndexMagic || h->formatVersion != IndexFormatVersion)
+        return false;
+
+    // Every section has to fit into the image
+    const auto fits = [size](quint32 offset, qint64 count, qint64 elementSize) {
+        return offset % sizeof(quint32) == 0 && offset + count * elementSize <= size;
+    };
+
+    if (!fits(h->entriesOffset, h->symbolCount, sizeof(Entry))
+            || !fits(h->namesOffset, h->nameArenaSize, sizeof(ushort))
+            || !fits(h->foldedNamesOffset, h->nameArenaSize, sizeof(ushort))
+            || !fits(h->pathsOffset, h->pathArenaSize, sizeof(ushort))
+            || !fits(h->separatorsOffset, h->separatorCount, sizeof(quint16))
+            || !fits(h->charMasksOffset, h->symbolCount, sizeof(quint64))
+            || !fits(h->typesOffset, h->typeCount + 1, sizeof(quint32))
+            || !fits(h->gramTableOffset, GramBucketCount + 1, sizeof(quint32))
+            || !fits(h->postingsOffset, h->postingCount, sizeof(quint32))
+            || !fits(h->keyOffset, h->keyLength, sizeof(ushort))) {
+        return false;
+    }
+
+    const quint32 *typeOffsets = reinterpret_cast<const quint32 *>(base + h->typesOffset);
+    if (typeOffsets[0] != 0 || !fits(h->typeArenaOffset, typeOffsets[h->typeCount], sizeof(ushort)))
+        return false;
+    for (quint32 i = 0; i < h->typeCount; ++i) {
+        if (typeOffsets[i] > typeOffsets[i + 1])
+            return false;
+    }
+
+    const quint32 *gramTable = reinterpret_cast<const quint32 *>(base + h->gramTableOffset);
+    return gramTable[0] == 0 && gramTable[GramBucketCount] == h->postingCount;
+}
+
+/// Checks every entry and posting list of an image that passed isValidImage().
+bool SymbolIndex::hasValidEntries(const uchar *base)
+{
+    const Header *h = reinterpret_cast<const Header *>(base);
+
+    // Names are laid out in id order, the arena scan in find() relies on it
+    const Entry *entries = reinterpret_cast<const Entry *>(base + h->entriesOffset);
+    quint64 nameEnd = 0;
+    for (quint32 id = 0; id < h->symbolCount; ++id) {
+        const Entry &e = entries[id];
+        if (e.nameOffset < nameEnd
+                || quint64(e.nameOffset) + e.nameLength + 1 > h->nameArenaSize
+                || quint64(e.pathOffset) + e.pathLength > h->pathArenaSize
+                || quint64(e.separatorOffset) + e.separatorCount > h->separatorCount
+                || e.typeId >= h->typeCount) {
+            return false;
+        }
+        nameEnd = quint64(e.nameOffset) + e.nameLength + 1;
+    }
+
+    // Posting lists have to be sorted ids of existing symbols
+    const quint32 *gramTable = reinterpret_cast<const quint32 *>(base + h->gramTableOffset);
+    const quint32 *postings = reinterpret_cast<const quint32 *>(base + h->postingsOffset);
+    for (int bucket = 0; bucket < GramBucketCount; ++bucket) {
+        const quint32 begin = gramTable[bucket];
+        const quint32 end = gramTable[bucket + 1];
+        if (begin > end)
+            return false;
+
+        for (quint32 i = begin; i < end; ++i) {
+            if (postings[i] >= h->symbolCount || (i > begin && postings[i] <= postings[i - 1]))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+const SymbolIndex::Header *SymbolIndex::header() const
+{
+    return reinterpret_cast<const Header *>(m_base);
+}
+
+const SymbolIndex::Entry &SymbolIndex::entry(int id) const
+{
+    return reinterpret_cast<const Entry *>(m_base + header()->entriesOffset)[id];
+}
+
+const ushort *SymbolIndex::names() const
+{
+    return reinterpret_cast<const ushort *>(m_base + header()->namesOffset);
+}
+
+const ushort *SymbolIndex::foldedNames() const
+{
+    return reinterpret_cast<const ushort *>(m_base + header()->foldedNamesOffset);
+}
+
+const ushort *SymbolIndex::paths() const
+{
+    return reinterpret_cast<const ushort *>(m_base + header()->pathsOffset);
+}
+
+const quint16 *SymbolIndex::separators() const
+{
+    return reinterpret_cast<const quint16 *>(m_base + header()->separatorsOffset);
+}
+
+const quint32 *SymbolIndex::gramTable() const
+{
+    return reinterpret_cast<const quint32 *>(m_base + header()->gramTableOffset);
+}
+
+const quint32 *SymbolIndex::postings() const
+{
+    return reinterpret_cast<const quint32 *>(m_base + header()->postingsOffset);
+}
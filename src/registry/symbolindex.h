@@ -0,0 +1,164 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 Oleg Shparber
+** Copyright (C) 2013-2014 Jerzy Kozera
+** Contact: http://zealdocs.org/contact.html
+**
+** This file is part of Zeal.
+**
+** Zeal is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** Zeal is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Zeal. If not, see <http://www.gnu.org/licenses/>.
+**
+****************************************************************************/
+
+#ifndef SYMBOLINDEX_H
+#define SYMBOLINDEX_H
+
+#include "cancellationtoken.h"
+
+#include <memory>
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class QFile;
+
+namespace Zeal {
+
+class SubstringMatcher;
+
+/**
+ * @brief The SymbolIndex class
+ * An immutable in-memory index of all symbols in a docset.
+ *
+ * Symbols are sorted by their case folded name and stored in a single flat
+ * image: a table of fixed size entries, contiguous UTF-16 arenas for names,
+ * case folded names and paths, positions of separators used for scoring,
+ * character bitmasks used to reject candidates early, and a table of
+ * interned symbol types.
+ *
+ * Substring lookups go through trigram posting lists, so only symbols that
+ * contain the rarest trigram of a query are verified.
+ *
+ * The image has no pointers, so it can be saved as is and memory-mapped
+ * on later runs. A key identifies the data an image was built from.
+ */
+class SymbolIndex
+{
+public:
+    /**
+     * @brief The Builder class
+     * Collects symbols and lays them out into a SymbolIndex.
+     */
+    class Builder
+    {
+    public:
+        void addSymbol(const QString &name, const QString &type, const QString &path);
+        std::unique_ptr<SymbolIndex> build(const QString &key = QString());
+
+    private:
+        struct Symbol {
+            QString name;
+            QString foldedName;
+            QString type;
+            QString path;
+            QVector<quint16> separatorEnds;
+        };
+
+        QVector<Symbol> m_symbols;
+    };
+
+    ~SymbolIndex();
+
+    enum class Verification {
+        Sections,   ///< Header and section bounds, in constant time
+        Full        ///< Also every entry and posting list, reads the whole image
+    };
+
+    /**
+     * @brief open
+     * Maps an index file, returns nullptr if it is truncated, corrupted or was built with a different key.
+     * A full verification is only needed once, right after the file is written.
+     */
+    static std::unique_ptr<SymbolIndex> open(const QString &fileName, const QString &key,
+                                             Verification verification = Verification::Sections);
+    bool save(const QString &fileName) const;
+
+    QString key() const;
+    int symbolCount() const;
+
+    QString name(int id) const;
+    /// Returns the name without copying it, the string is only valid while the index exists.
+    QString nameRef(int id) const;
+    QString type(int id) const;
+    QString path(int id) const;
+
+    int nameLength(int id) const;
+    /// Returns unterminated name characters, valid while the index exists.
+    const QChar *nameData(int id) const;
+    const QChar *foldedNameData(int id) const;
+
+    /// Returns a bitmask of characters in the case folded symbol name.
+    /// A symbol can contain a string only if it has all bits of its charMask().
+    quint64 charMask(int id) const;
+    static quint64 charMask(const QString &foldedStr);
+
+    /// Returns number of separators (".", "::" or "/") that end at or before \a pos in the symbol name.
+    int separatorCount(int id, int pos) const;
+    /// Returns true if the symbol name has a separator right before \a pos.
+    bool endsWithSeparator(int id, int pos) const;
+
+    /// Returns position of the case folded \a foldedQuery in the symbol name or -1.
+    int indexOf(int id, const QString &foldedQuery) const;
+    int indexOf(int id, const SubstringMatcher &matcher) const;
+
+    /// Returns ids of symbols in range [\a first, \a last) containing \a query, in index order.
+    QVector<int> find(const QString &query, int first, int last, const CancellationToken &token) const;
+    /// Returns ids of symbols containing \a query out of sorted candidates [\a candidates, \a candidatesEnd).
+    QVector<int> find(const QString &query, const int *candidates, const int *candidatesEnd,
+                      const CancellationToken &token) const;
+
+    static QString foldCase(const QString &str);
+
+private:
+    struct Header;
+    struct Entry;
+
+    explicit SymbolIndex(const QByteArray &data);
+    SymbolIndex(std::unique_ptr<QFile> file, const uchar *base);
+
+    void loadTypes();
+    void shortestPostingList(const QString &foldedQuery, const quint32 **begin,
+                             const quint32 **end) const;
+    static bool isValidImage(const uchar *base, qint64 size);
+    static bool hasValidEntries(const uchar *base);
+
+    const Header *header() const;
+    const Entry &entry(int id) const;
+    const ushort *names() const;
+    const ushort *foldedNames() const;
+    const ushort *paths() const;
+    const quint16 *separators() const;
+    const quint32 *gramTable() const;
+    const quint32 *postings() const;
+
+    QByteArray m_data;
+    std::unique_ptr<QFile> m_file;
+    const uchar *m_base = nullptr;
+    QStringList m_types;
+};
+
+} // namespace Zeal
+
+#endif // SYMBOLINDEX_H
@@ -0,0 +1,145 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 Oleg Shparber
+** Copyright (C) 2013-2014 Jerzy Kozera
+** Contact: http://zealdocs.org/contact.html
+**
+** This file is part of Zeal.
+**
+** Zeal is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** Zeal is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Zeal. If not, see <http://www.gnu.org/licenses/>.
+**
+****************************************************************************/
+
+#include "toccache.h"
+
+using namespace Zeal;
+
+namespace Zeal {
+
+uint qHash(const TocCache::Key &key, uint seed)
+{
+    return ::qHash(key.owner, seed) ^ ::qHash(key.symbolType, seed) ^ ::qHash(key.page, seed);
+}
+
+} // namespace Zeal
+
+bool TocCache::Key::operator==(const Key &other) const
+{
+    return owner == other.owner && page == other.page && symbolType == other.symbolType;
+}
+
+TocCache::TocCache(qint64 budget) :
+    m_budget(budget)
+{
+}
+
+TocCache *TocCache::instance()
+{
+    static TocCache cache;
+    return &cache;
+}
+
+TocCache::Page TocCache::find(const void *owner, const QString &symbolType, int page)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_entries.find(Key{owner, symbolType, page});
+    if (it == m_entries.end())
+        return nullptr;
+
+    m_lru.splice(m_lru.begin(), m_lru, it->lruIterator);
+    return it->page;
+}
+
+TocCache::Page TocCache::insert(const void *owner, const QString &symbolType, int page,
+                                const QVector<Docset::Symbol> &symbols)
+{
+    // The last page of a group is usually shorter, do not keep spare capacity around
+    QVector<Docset::Symbol> compactSymbols(symbols);
+    compactSymbols.squeeze();
+
+    Entry entry;
+    entry.page = std::make_shared<const QVector<Docset::Symbol>>(compactSymbols);
+    entry.size = pageSize(*entry.page);
+
+    QMutexLocker locker(&m_mutex);
+
+    const Key key{owner, symbolType, page};
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+        m_size -= it->size;
+        m_lru.erase(it->lruIterator);
+        m_entries.erase(it);
+    }
+
+    if (entry.size > m_budget)
+        return entry.page;
+
+    m_lru.push_front(key);
+    entry.lruIterator = m_lru.begin();
+    m_entries.insert(key, entry);
+    m_size += entry.size;
+
+    evict();
+    return entry.page;
+}
+
+void TocCache::remove(const void *owner)
+{
+    QMutexLocker locker(&m_mutex);
+
+    for (auto it = m_lru.begin(); it != m_lru.end();) {
+        if (it->owner == owner) {
+            m_size -= m_entries.take(*it).size;
+            it = m_lru.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+qint64 TocCache::budget() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_budget;
+}
+
+void TocCache::setBudget(qint64 budget)
+{
+    QMutexLocker locker(&m_mutex);
+    m_budget = budget;
+    evict();
+}
+
+qint64 TocCache::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_size;
+}
+
+qint64 TocCache::pageSize(const QVector<Docset::Symbol> &symbols)
+{
+    qint64 size = sizeof(Entry) + sizeof(Key) + symbols.capacity() * sizeof(Docset::Symbol);
+    for (const Docset::Symbol &symbol : symbols)
+        size += (symbol.name.capacity() + symbol.path.capacity()) * sizeof(QChar);
+    return size;
+}
+
+void TocCache::evict()
+{
+    while (m_size > m_budget && !m_lru.empty()) {
+        m_size -= m_entries.take(m_lru.back()).size;
+        m_lru.pop_back();
+    }
+}
@@ -0,0 +1,100 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 Oleg Shparber
+** Copyright (C) 2013-2014 Jerzy Kozera
+** Contact: http://zealdocs.org/contact.html
+**
+** This file is part of Zeal.
+**
+** Zeal is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** Zeal is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Zeal. If not, see <http://www.gnu.org/licenses/>.
+**
+****************************************************************************/
+
+#ifndef TOCCACHE_H
+#define TOCCACHE_H
+
+#include "docset.h"
+
+#include <list>
+#include <memory>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+namespace Zeal {
+
+/**
+ * @brief The TocCache class
+ * A byte-budgeted cache of ToC symbol pages, shared by all docsets.
+ *
+ * Pages are keyed by their owner (a docset), symbol type and page number.
+ * The least recently used pages are evicted once they exceed the budget,
+ * and are read from the docset again when they are needed.
+ */
+class TocCache
+{
+public:
+    typedef std::shared_ptr<const QVector<Docset::Symbol>> Page;
+
+    explicit TocCache(qint64 budget = DefaultBudget);
+
+    static TocCache *instance();
+
+    /// Returns a cached page, or nullptr.
+    Page find(const void *owner, const QString &symbolType, int page);
+    /// Stores \a symbols as a page and returns it, the page stays valid after it is evicted.
+    Page insert(const void *owner, const QString &symbolType, int page,
+                const QVector<Docset::Symbol> &symbols);
+    /// Drops all pages of \a owner, must be called before the owner is destroyed.
+    void remove(const void *owner);
+
+    qint64 budget() const;
+    void setBudget(qint64 budget);
+    /// Returns the number of bytes used by cached pages.
+    qint64 size() const;
+
+    static const qint64 DefaultBudget = 16 * 1024 * 1024;
+
+private:
+    struct Key {
+        const void *owner;
+        QString symbolType;
+        int page;
+
+        bool operator==(const Key &other) const;
+    };
+
+    struct Entry {
+        Page page;
+        qint64 size;
+        std::list<Key>::iterator lruIterator;
+    };
+
+    friend uint qHash(const Key &key, uint seed);
+
+    static qint64 pageSize(const QVector<Docset::Symbol> &symbols);
+    void evict();
+
+    mutable QMutex m_mutex;
+    qint64 m_budget;
+    qint64 m_size = 0;
+    QHash<Key, Entry> m_entries;
+    // Keys of cached pages, most recently used first
+    std::list<Key> m_lru;
+};
+
+} // namespace Zeal
+
+#endif // TOCCACHE_H
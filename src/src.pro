@@ -15,6 +15,13 @@ portable {
     DEFINES += PORTABLE_BUILD
 }
 
+# Interrupts SQLite queries of superseded searches.
+# Qt SQLite plugin must use the same system SQLite library.
+sqlite_interrupt {
+    DEFINES += USE_SQLITE_INTERRUPT
+    LIBS += -lsqlite3
+}
+
 VERSION = 0.2.1
 DEFINES += ZEAL_VERSION=\\\"$${VERSION}\\\"
 
@@ -28,6 +28,7 @@
 #include "zealjs.h"
 #include "networkaccessmanager.h"
 #include "searchitemdelegate.h"
+#include "searchstatisticsdialog.h"
 #include "seealsodelegate.h"
 #include "settingsdialog.h"
 #include "core/application.h"
@@ -188,6 +189,10 @@ MainWindow::MainWindow(Core::Application *app, QWidget *parent) :
         std::unique_ptr<AboutDialog> dialog(new AboutDialog(this));
         dialog->exec();
     });
+    connect(ui->actionSearchStatistics, &QAction::triggered, [this]() {
+        std::unique_ptr<SearchStatisticsDialog> dialog(new SearchStatisticsDialog(this));
+        dialog->exec();
+    });
     connect(ui->actionAboutQt, &QAction::triggered, [this]() {
         QMessageBox::aboutQt(this);
     });
@@ -250,9 +255,14 @@ MainWindow::MainWindow(Core::Application *app, QWidget *parent) :
         const QString name = docsetName(url);
         m_tabBar->setTabIcon(m_tabBar->currentIndex(), docsetIcon(url));
 
-        Docset *docset = m_application->docsetRegistry()->docset(name);
-        if (docset)
-            currentSearchState()->sectionsList->setResults(docset->relatedLinks(url));
+        const std::shared_ptr<Docset> docset = m_application->docsetRegistry()->docset(name);
+        if (docset) {
+            // Sections of a docset that is not open yet are listed once it is opened in background
+            if (docset->isOpen())
+                currentSearchState()->sectionsList->setResults(docset->relatedLinks(url));
+            else
+                m_application->docsetRegistry()->openDocset(name);
+        }
 
         displayViewActions();
     });
@@ -272,7 +282,8 @@ MainWindow::MainWindow(Core::Application *app, QWidget *parent) :
             QDesktopServices::openUrl(url);
     });
 
-    connect(m_application->docsetRegistry(), &DocsetRegistry::queryCompleted, this, &MainWindow::onSearchComplete);
+    connect(m_application->docsetRegistry(), &DocsetRegistry::queryResultsAvailable,
+            this, &MainWindow::onSearchResultsAvailable);
 
     connect(m_application->docsetRegistry(), &DocsetRegistry::docsetRemoved,
             this, [this](const QString &name) {
@@ -291,6 +302,27 @@ MainWindow::MainWindow(Core::Application *app, QWidget *parent) :
         setupSearchBoxCompletions();
     });
 
+    connect(m_application->docsetRegistry(), &DocsetRegistry::docsetOpened,
+            this, [this](const QString &name) {
+        const QUrl url = WebPageHelpers::url(currentSearchState()->page);
+        if (docsetName(url) != name)
+            return;
+
+        const std::shared_ptr<Docset> docset = m_application->docsetRegistry()->docset(name);
+        if (docset && docset->isOpen())
+            currentSearchState()->sectionsList->setResults(docset->relatedLinks(url));
+    });
+
+    // Docsets are loaded in background, refresh results of a query typed in the meantime
+    connect(m_application->docsetRegistry(), &DocsetRegistry::docsetsLoaded, this, [this]() {
+        if (!m_searchState || m_searchState->searchQuery.isEmpty())
+            return;
+
+        m_cancelSearch.cancel();
+        m_cancelSearch = CancellationToken();
+        m_application->docsetRegistry()->search(m_searchState->searchQuery, m_cancelSearch);
+    });
+
     connect(m_application->docsetRegistry(), &DocsetRegistry::keywordGroupsChanged,
             this, &MainWindow::setupSearchBoxCompletions);
 
@@ -479,7 +511,7 @@ QString MainWindow::docsetName(const QUrl &url) const
 QIcon MainWindow::docsetIcon(const QUrl &url) const
 {
     QString name = docsetName(url);
-    const Docset * const docset = m_application->docsetRegistry()->docset(name);
+    const std::shared_ptr<Docset> docset = m_application->docsetRegistry()->docset(name);
     if (docset)
         return docset->icon();
     else if (url.scheme() == "qrc")
@@ -728,9 +760,12 @@ void MainWindow::saveTabState()
     m_searchState->zoomFactor = ui->webView->zoomFactor();
 }
 
-void MainWindow::onSearchComplete()
+void MainWindow::onSearchResultsAvailable(const QList<SearchResult> &results, bool isFirstBatch)
 {
-    currentSearchState()->zealSearch->setResults(m_application->docsetRegistry()->queryResults());
+    if (isFirstBatch)
+        currentSearchState()->zealSearch->setResults(results);
+    else
+        currentSearchState()->zealSearch->addResults(results, DocsetRegistry::MaxResults);
 }
 
 /**
@@ -1046,6 +1081,8 @@ void MainWindow::applySettings()
     m_globalShortcut->setShortcut(m_settings->showShortcut);
     m_application->docsetRegistry()->setKeywordGroups(m_settings->docsetKeywordGroups);
     m_application->docsetRegistry()->setUserDefinedKeywords(m_settings->docsetKeywords);
+    m_application->docsetRegistry()->setFuzzySearchEnabled(m_settings->fuzzySearch);
+    m_application->docsetRegistry()->setPrefetchEnabled(m_settings->prefetchSearch);
 
     if (m_settings->showSystrayIcon)
         createTrayIcon();
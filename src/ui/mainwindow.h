@@ -25,6 +25,7 @@
 #define MAINWINDOW_H
 
 #include "registry/searchquery.h"
+#include "registry/searchresult.h"
 #include "registry/cancellationtoken.h"
 
 #include <memory>
@@ -130,7 +131,7 @@ private slots:
     void applySettings();
     void back();
     void forward();
-    void onSearchComplete();
+    void onSearchResultsAvailable(const QList<Zeal::SearchResult> &results, bool isFirstBatch);
     void deferOpenDocset(const QModelIndex &index);
     void openDocset(const QModelIndex &index);
     void queryCompleted();
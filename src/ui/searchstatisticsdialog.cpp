@@ -0,0 +1,132 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 Oleg Shparber
+** Contact: http://zealdocs.org/contact.html
+**
+** This file is part of Zeal.
+**
+** Zeal is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** Zeal is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Zeal. If not, see <http://www.gnu.org/licenses/>.
+**
+****************************************************************************/
+
+
+#include "searchstatisticsdialog.h"
+#include "ui_searchstatisticsdialog.h"
+
+#include "registry/searchstatistics.h"
+
+#include <QFileDialog>
+#include <QFontDatabase>
+#include <QJsonDocument>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSaveFile>
+
+using namespace Zeal;
+
+namespace {
+QString histogramRow(const QString &name, const QJsonObject &histogram)
+{
+    return QStringLiteral("%1 %2 %3 %4 %5 %6 %7\n")
+            .arg(name.left(24), -24)
+            .arg(histogram.value(QStringLiteral("count")).toDouble(), 8, 'f', 0)
+            .arg(histogram.value(QStringLiteral("mean_us")).toDouble(), 10, 'f', 0)
+            .arg(histogram.value(QStringLiteral("p50_us")).toDouble(), 10, 'f', 0)
+            .arg(histogram.value(QStringLiteral("p90_us")).toDouble(), 10, 'f', 0)
+            .arg(histogram.value(QStringLiteral("p99_us")).toDouble(), 10, 'f', 0)
+            .arg(histogram.value(QStringLiteral("max_us")).toDouble(), 10, 'f', 0);
+}
+}
+
+SearchStatisticsDialog::SearchStatisticsDialog(QWidget *parent) :
+    QDialog(parent),
+    ui(std::unique_ptr<Ui::SearchStatisticsDialog>(new Ui::SearchStatisticsDialog))
+{
+    ui->setupUi(this);
+    ui->reportEdit->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+
+    QPushButton *refreshButton = ui->buttonBox->addButton(tr("Refresh"), QDialogButtonBox::ActionRole);
+    connect(refreshButton, &QPushButton::clicked, this, &SearchStatisticsDialog::refresh);
+
+    ui->buttonBox->button(QDialogButtonBox::Save)->setText(tr("Save as JSON..."));
+    connect(ui->buttonBox->button(QDialogButtonBox::Save), &QPushButton::clicked,
+            this, &SearchStatisticsDialog::saveJson);
+    connect(ui->buttonBox->button(QDialogButtonBox::Reset), &QPushButton::clicked, [this]() {
+        SearchStatistics::instance()->reset();
+        refresh();
+    });
+
+    refresh();
+}
+
+SearchStatisticsDialog::~SearchStatisticsDialog()
+{
+}
+
+void SearchStatisticsDialog::refresh()
+{
+    const QJsonObject statistics = SearchStatistics::instance()->toJson();
+    const QString header = QStringLiteral("%1 %2 %3 %4 %5 %6 %7\n")
+            .arg(QString(), -24)
+            .arg(tr("count"), 8)
+            .arg(tr("mean us"), 10)
+            .arg(tr("p50 us"), 10)
+            .arg(tr("p90 us"), 10)
+            .arg(tr("p99 us"), 10)
+            .arg(tr("max us"), 10);
+
+    QString report = tr("Stages") + QLatin1Char('\n') + header;
+    const QJsonObject stages = statistics.value(QStringLiteral("stages")).toObject();
+    for (auto it = stages.constBegin(); it != stages.constEnd(); ++it)
+        report += histogramRow(it.key(), it.value().toObject());
+
+    report += QLatin1Char('\n') + tr("Docsets") + QLatin1Char('\n') + header;
+    const QJsonObject docsets = statistics.value(QStringLiteral("docsets")).toObject();
+    for (auto it = docsets.constBegin(); it != docsets.constEnd(); ++it)
+        report += histogramRow(it.key(), it.value().toObject());
+
+    const QJsonObject cache = statistics.value(QStringLiteral("prefix_cache")).toObject();
+    report += QLatin1Char('\n') + tr("Prefix cache") + QLatin1Char('\n');
+    report += tr("Hits: %1 of %2 lookups (%3%)\n")
+            .arg(cache.value(QStringLiteral("hits")).toDouble(), 0, 'f', 0)
+            .arg(cache.value(QStringLiteral("lookups")).toDouble(), 0, 'f', 0)
+            .arg(cache.value(QStringLiteral("hit_rate")).toDouble() * 100, 0, 'f', 1);
+    report += tr("Size: %1 of %2 KiB\n")
+            .arg(cache.value(QStringLiteral("size_bytes")).toDouble() / 1024, 0, 'f', 0)
+            .arg(cache.value(QStringLiteral("budget_bytes")).toDouble() / 1024, 0, 'f', 0);
+
+    const QJsonObject toc = statistics.value(QStringLiteral("toc_cache")).toObject();
+    report += QLatin1Char('\n') + tr("ToC cache") + QLatin1Char('\n');
+    report += tr("Size: %1 of %2 KiB\n")
+            .arg(toc.value(QStringLiteral("size_bytes")).toDouble() / 1024, 0, 'f', 0)
+            .arg(toc.value(QStringLiteral("budget_bytes")).toDouble() / 1024, 0, 'f', 0);
+
+    ui->reportEdit->setPlainText(report);
+}
+
+void SearchStatisticsDialog::saveJson()
+{
+    const QString fileName = QFileDialog::getSaveFileName(this, tr("Save Search Statistics"),
+                                                          QStringLiteral("search-statistics.json"),
+                                                          tr("JSON files (*.json)"));
+    if (fileName.isEmpty())
+        return;
+
+    QSaveFile file(fileName);
+    const QJsonDocument document(SearchStatistics::instance()->toJson());
+    if (!file.open(QIODevice::WriteOnly) || file.write(document.toJson()) == -1 || !file.commit()) {
+        QMessageBox::warning(this, tr("Error"),
+                             QString(tr("Cannot save statistics to <b>%1</b>!")).arg(fileName));
+    }
+}
@@ -0,0 +1,53 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 Oleg Shparber
+** Contact: http://zealdocs.org/contact.html
+**
+** This file is part of Zeal.
+**
+** Zeal is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** Zeal is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Zeal. If not, see <http://www.gnu.org/licenses/>.
+**
+****************************************************************************/
+
+
+#ifndef SEARCHSTATISTICSDIALOG_H
+#define SEARCHSTATISTICSDIALOG_H
+
+#include <memory>
+#include <QDialog>
+
+namespace Ui {
+class SearchStatisticsDialog;
+}
+
+/**
+ * @brief The SearchStatisticsDialog class
+ * Shows search latencies and cache hit rates, which can be saved as JSON.
+ */
+class SearchStatisticsDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    explicit SearchStatisticsDialog(QWidget *parent = nullptr);
+    ~SearchStatisticsDialog() override;
+
+private slots:
+    void refresh();
+    void saveJson();
+
+private:
+    std::unique_ptr<Ui::SearchStatisticsDialog> ui;
+};
+
+#endif // SEARCHSTATISTICSDIALOG_H
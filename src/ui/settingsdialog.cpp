@@ -256,7 +256,7 @@ void SettingsDialog::updateSelectedDocsets()
 
 void SettingsDialog::updateAllDocsets()
 {
-    for (const Docset * const docset : m_docsetRegistry->docsets()) {
+    for (const std::shared_ptr<Docset> &docset : m_docsetRegistry->docsets()) {
         if (!docset->hasUpdate)
             continue;
 
@@ -632,7 +632,7 @@ QListWidgetItem *SettingsDialog::findDocsetListItem(const QString &title) const
 
 bool SettingsDialog::updatesAvailable() const
 {
-    for (Docset *docset : m_docsetRegistry->docsets()) {
+    for (const std::shared_ptr<Docset> &docset : m_docsetRegistry->docsets()) {
         if (docset->hasUpdate)
             return true;
     }
@@ -705,11 +705,10 @@ void SettingsDialog::processDocsetList(const QJsonArray &list)
         listItem->setData(ListModel::DocsetNameRole, metadata.name());
         listItem->setCheckState(Qt::Unchecked);
 
-        if (m_docsetRegistry->contains(metadata.name())) {
+        const std::shared_ptr<Docset> docset = m_docsetRegistry->docset(metadata.name());
+        if (docset) {
             listItem->setHidden(true);
 
-            Docset *docset = m_docsetRegistry->docset(metadata.name());
-
             if (metadata.latestVersion() != docset->version()
                     || (metadata.latestVersion() == docset->version()
                         && metadata.revision() > docset->revision())) {
@@ -744,7 +743,8 @@ void SettingsDialog::downloadDashDocset(const QString &name)
 void SettingsDialog::removeDocsets(const QStringList &names)
 {
     for (const QString &name : names) {
-        const QString title = m_docsetRegistry->docset(name)->title();
+        const std::shared_ptr<Docset> docset = m_docsetRegistry->docset(name);
+        const QString title = docset ? docset->title() : name;
         m_docsetRegistry->remove(name);
 
         const QDir dataDir(m_application->settings()->docsetPath);
@@ -794,7 +794,7 @@ void SettingsDialog::displayKeywordGroup(int keywordGroupRow)
 
     // Clear and rebuild selections.
     ui->keywordGroupsDocsetSelection->clear();
-    for (Docset *docset: m_docsetRegistry->docsets()) {
+    for (const std::shared_ptr<Docset> &docset : m_docsetRegistry->docsets()) {
         QListWidgetItem *docsetSelection = new QListWidgetItem(docset->icon(), docset->name());
 
         docsetSelection->setFlags(docsetSelection->flags() | Qt::ItemIsUserCheckable);
@@ -872,6 +872,9 @@ void SettingsDialog::loadSettings()
 
     ui->toolButton->setKeySequence(settings->showShortcut);
 
+    ui->fuzzySearchCheckBox->setChecked(settings->fuzzySearch);
+    ui->prefetchSearchCheckBox->setChecked(settings->prefetchSearch);
+
     //
     ui->minFontSize->setValue(settings->minimumFontSize);
     ui->storageEdit->setText(QDir::toNativeSeparators(settings->docsetPath));
@@ -919,6 +922,9 @@ void SettingsDialog::saveSettings()
 
     settings->showShortcut = ui->toolButton->keySequence();
 
+    settings->fuzzySearch = ui->fuzzySearchCheckBox->isChecked();
+    settings->prefetchSearch = ui->prefetchSearchCheckBox->isChecked();
+
     //
     settings->minimumFontSize = ui->minFontSize->text().toInt();
 